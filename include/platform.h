@@ -5,6 +5,8 @@
 #ifndef PLATFORM_H
 #define PLATFORM_H
 
+#include <board.h>
+
 #define READ_KEY(button, key) case(key):{\
 input.buttons[button].changed = is_down != input.buttons[button].is_down;\
 input.buttons[button].is_down = is_down;\
@@ -21,6 +23,9 @@ namespace platform
 
         static constexpr SDL_Color COLOR{34, 12, 16, 255};
 
+        // Longest the loop sleeps without a frame request, also the poll rate while minimised
+        constexpr uint32_t IDLE_WAIT_MS{1000};
+
         namespace score
         {
             static auto TITLE{"Score Board"};
@@ -53,10 +58,29 @@ namespace platform
         {
             typedef struct BOARD_SETTINGS
             {
-                uint8_t w;
-                uint8_t h;
-                uint8_t mines;
+                uint32_t w;
+                uint32_t h;
+                uint32_t mines;
+                // 0 picks a fresh seed per game, anything else replays the same layout
+                uint64_t seed;
+                // Only deal boards the solver clears from the first click without guessing
+                bool no_guess;
             } board_settings_t;
+
+            constexpr uint32_t MAX_SIZE{Board::MAX_SIZE};
+
+            constexpr board_settings_t DEFAULT{8, 8, 10, 0, false};
+            // Stress workload, selected with --large
+            constexpr board_settings_t LARGE{10000, 10000, 15000000, 0, false};
+
+            // No-guess search is skipped past this size, solving every candidate would take too long
+            constexpr uint64_t NO_GUESS_MAX_CELLS{1u << 20};
+
+            // Cells around the first click kept free of mines, 1 gives the 3x3 opening
+            constexpr int SAFE_RADIUS{1};
+
+            // Time a cascading reveal may take per frame before it continues on the next one
+            constexpr uint32_t REVEAL_BUDGET_US{4000};
         }
 
         namespace block
@@ -71,6 +95,48 @@ namespace platform
             constexpr int SIZE{50};
             constexpr int OFFSET{2};
         }
+
+        namespace camera
+        {
+            // Keyboard pan speed in screen pixels per second
+            constexpr float PAN_SPEED{900.0f};
+            // Zoom factor applied per mouse wheel notch
+            constexpr float ZOOM_STEP{1.15f};
+
+            // Floor for boards that already fit the window, larger ones zoom out until they fit
+            constexpr float MIN_ZOOM{0.08f};
+            constexpr float MAX_ZOOM{4.0f};
+
+            // Below this on screen cell pitch the board is drawn from the minimap texture
+            constexpr float LOD_CELL_PX{4.0f};
+        }
+
+        namespace minimap
+        {
+            // Longest side of the overlay in pixels
+            constexpr float SIZE{180.0f};
+            constexpr float MARGIN{10.0f};
+            constexpr float BORDER{2.0f};
+
+            constexpr SDL_Color FRAME{20, 8, 10, 255};
+            constexpr SDL_Color VIEW{255, 255, 255, 255};
+        }
+
+        namespace solver
+        {
+            // Deduction work per frame, the rest carries over like a cascading reveal
+            constexpr uint32_t BUDGET_US{2000};
+            // Cells auto-play opens per frame
+            constexpr int AUTO_MOVES_PER_FRAME{1};
+
+            constexpr SDL_Color HINT{40, 200, 90, 255};
+            constexpr float HINT_THICKNESS{3.0f};
+
+            // Backtracking nodes one frontier component may use before its probabilities are estimated
+            constexpr uint64_t PROBABILITY_WORK_CAP{1u << 20};
+            // Alpha of the probability heat map drawn over closed cells
+            constexpr uint8_t HEAT_ALPHA{120};
+        }
     }
 
     namespace input
@@ -85,14 +151,22 @@ namespace platform
         {
             UP,
             DOWN,
+            LEFT,
+            RIGHT,
 
             W,
             S,
             A,
             D,
+            M,
+            H,
+            P,
+            I,
+            F3,
 
             MOUSE_LEFT,
             MOUSE_RIGHT,
+            MOUSE_MIDDLE,
 
             BUTTON_COUNT,
         };
@@ -100,6 +174,8 @@ namespace platform
         typedef struct INPUT
         {
             button_state_t buttons[BUTTON_COUNT];
+            // Wheel notches this frame, positive away from the user
+            int wheel;
         } input_t;
     }
 
@@ -0,0 +1,550 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "board.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "neighbour_count.h"
+#include "rng.h"
+#include "trace.h"
+
+static int lowest_bit(const uint64_t word)
+{
+#if defined(_MSC_VER)
+    int bit = 0;
+    while (!((word >> bit) & 1u)) ++bit;
+    return bit;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+static int bit_count(uint64_t word)
+{
+#if defined(_MSC_VER)
+    int count = 0;
+    for (; word; word &= word - 1) ++count;
+    return count;
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Calls fn(x) for every set bit of the row starting at `begin`, `width` cells wide
+template <typename Fn>
+static void for_each_set(const std::vector<uint64_t>& plane, const size_t begin, const size_t width, Fn fn)
+{
+    if (width == 0) return;
+
+    const size_t end = begin + width;
+    const size_t first = begin >> 6;
+    const size_t last = (end - 1) >> 6;
+
+    for (size_t w = first; w <= last; ++w)
+    {
+        uint64_t word = plane[w];
+        if (w == first) word &= ~uint64_t{0} << (begin & 63);
+        if (w == last) word &= ~uint64_t{0} >> (63 - ((end - 1) & 63));
+
+        while (word)
+        {
+            fn((w << 6) + static_cast<size_t>(lowest_bit(word)) - begin);
+            word &= word - 1;
+        }
+    }
+}
+
+void Board::init(const int _cols, const int _rows, const int _mines)
+{
+    cols = _cols > 0 ? _cols : 0;
+    rows = _rows > 0 ? _rows : 0;
+
+    const size_t cells = static_cast<size_t>(cols) * static_cast<size_t>(rows);
+
+    // Always leave at least the first click safe
+    amount_of_mines = _mines > 0 ? _mines : 0;
+    if (cells > 0 && static_cast<size_t>(amount_of_mines) >= cells)
+    {
+        amount_of_mines = static_cast<int>(cells - 1);
+    }
+
+    safe_cells = cells - static_cast<size_t>(amount_of_mines);
+    revealed_safe = 0;
+    flag_count = 0;
+    correct_flags = 0;
+    state = board_state::PLAYING;
+    const size_t words = (cells + 63) / 64;
+
+    mine_bits.assign(words, 0);
+    revealed_bits.assign(words, 0);
+    flagged_bits.assign(words, 0);
+    counts.assign((cells + 1) / 2, 0);
+
+    // Sized by the board edge, a smaller board gives back what a larger one reserved
+    max_spans = span_limit(cols, rows);
+    spans.clear();
+    if (spans.capacity() > max_spans) spans.shrink_to_fit();
+    spans.reserve(max_spans);
+    rescan_y = 0;
+    rescan_end = 0;
+    rescan_x = 0;
+
+    // The whole board is new, a consumer has to redraw everything anyway
+    dirty.clear();
+    dirty_overflow = true;
+    dirty_lo = 0;
+    dirty_hi = cells > 0 ? cells - 1 : 0;
+
+    is_gen = false;
+}
+
+void Board::generate_tiles(const int safe_x, const int safe_y)
+{
+    TRACE_ZONE("generate_tiles");
+
+    if (cols <= 0 || rows <= 0) return;
+
+    const size_t cells = static_cast<size_t>(cols) * static_cast<size_t>(rows);
+    const size_t mines = static_cast<size_t>(amount_of_mines);
+
+    // Shrink the safe zone on boards too dense to keep all of it clear
+    int radius = std::max(0, safe_radius);
+    int sx0, sy0, sx1, sy1;
+    while (true)
+    {
+        sx0 = std::max(0, safe_x - radius);
+        sy0 = std::max(0, safe_y - radius);
+        sx1 = std::min(cols - 1, safe_x + radius);
+        sy1 = std::min(rows - 1, safe_y + radius);
+
+        const size_t safe_count = static_cast<size_t>(sx1 - sx0 + 1) * static_cast<size_t>(sy1 - sy0 + 1);
+        if (radius == 0 || cells - safe_count >= mines) break;
+        --radius;
+    }
+
+    const size_t safe_w = static_cast<size_t>(sx1 - sx0 + 1);
+    const size_t candidates = cells - safe_w * static_cast<size_t>(sy1 - sy0 + 1);
+
+    // Maps an index over the cells outside the safe zone back to a board index
+    auto to_cell = [&](size_t k)
+    {
+        for (int y = sy0; y <= sy1; ++y)
+        {
+            if (k < index(sx0, y)) break;
+            k += safe_w;
+        }
+        return k;
+    };
+
+    // Floyd's sampling: exactly one draw per mine and the mine plane is the only set needed
+    Rng rng{seed};
+    for (size_t j = candidates - mines; j < candidates; ++j)
+    {
+        const size_t t = to_cell(static_cast<size_t>(rng.bounded(j + 1)));
+        set_bit(mine_bits, is_mine(t) ? to_cell(j) : t);
+    }
+
+    neighbour_count::count(mine_bits.data(), cols, rows, counts.data(), neighbour_count::best_kernel());
+
+    // Flags placed before the first click had no mines to be right about
+    correct_flags = 0;
+    for (size_t w = 0; w < mine_bits.size(); ++w)
+    {
+        correct_flags += static_cast<size_t>(bit_count(mine_bits[w] & flagged_bits[w]));
+    }
+
+    is_gen = true;
+}
+
+board_state::STATE Board::reveal(const int x, const int y)
+{
+    TRACE_ZONE("reveal");
+
+    start_reveal(x, y);
+
+    while (is_revealing())
+    {
+        fill_step();
+    }
+
+    return state;
+}
+
+board_state::STATE Board::start_reveal(const int x, const int y)
+{
+    if (state != board_state::PLAYING || !in_bounds(x, y)) return state;
+
+    const size_t i = index(x, y);
+    if (is_revealed(i) || is_flagged(i)) return state;
+
+    if (!is_gen)
+    {
+        generate_tiles(x, y);
+    }
+
+    if (is_mine(i))
+    {
+        set_bit(revealed_bits, i);
+        mark_dirty(i);
+        state = board_state::LOST;
+        // Whatever was still cascading no longer matters
+        spans.clear();
+        rescan_end = rescan_y;
+        return state;
+    }
+
+    reveal_safe(i);
+    loop_around_tile(x, y);
+
+    return state;
+}
+
+bool Board::step_reveal(const uint32_t budget_us)
+{
+    if (!is_revealing()) return false;
+
+    TRACE_ZONE("step_reveal");
+
+    // Span sizes vary wildly, so the clock is read after a fixed amount of scanned cells instead
+    constexpr size_t cells_per_check = 4096;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(budget_us);
+    size_t scanned = 0;
+    while (is_revealing())
+    {
+        scanned += fill_step();
+
+        if (scanned >= cells_per_check)
+        {
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            scanned = 0;
+        }
+    }
+
+    return is_revealing();
+}
+
+bool Board::is_revealing() const
+{
+    return state == board_state::PLAYING && (!spans.empty() || rescan_y < rescan_end);
+}
+
+void Board::toggle_flag(const int x, const int y)
+{
+    if (state != board_state::PLAYING || !in_bounds(x, y)) return;
+
+    const size_t i = index(x, y);
+    if (is_revealed(i)) return;
+
+    flip_bit(flagged_bits, i);
+    mark_dirty(i);
+
+    // Before generation the mine plane is empty, generate_tiles counts the correct flags then
+    if (is_flagged(i))
+    {
+        ++flag_count;
+        if (is_gen && is_mine(i)) ++correct_flags;
+    }
+    else
+    {
+        --flag_count;
+        if (is_gen && is_mine(i)) --correct_flags;
+    }
+}
+
+void Board::loop_around_tile(const int pos_x, const int pos_y)
+{
+    TRACE_ZONE("loop_around_tile");
+
+    if (!in_bounds(pos_x, pos_y)) return;
+
+    const size_t start = index(pos_x, pos_y);
+    if (is_mine(start)) return;
+
+    const bool start_is_zero = (mines_around(start) == 0);
+    if (!start_is_zero)
+    {
+        return;
+    }
+
+    if (!is_revealed(start))
+    {
+        reveal_safe(start);
+    }
+
+    // The revealed plane doubles as the visited set: a zero cell is queued
+    // in the same step that reveals it, so every cell is opened at most once.
+    // Further clicks during a running cascade add to the same stack.
+    push_run(pos_x, pos_y);
+}
+
+size_t Board::fill_step()
+{
+    if (spans.empty()) return rescan_row();
+
+    const span_t& span = spans.back();
+    const size_t scanned = 3 * static_cast<size_t>(span.x1 - span.x0 + 3);
+    expand_span();
+    return scanned;
+}
+
+void Board::expand_span()
+{
+    const span_t span = spans.back();
+    spans.pop_back();
+
+    const int x0 = std::max(0, span.x0 - 1);
+    const int x1 = std::min(cols - 1, span.x1 + 1);
+
+    if (span.y > 0) scan_row(span.y - 1, x0, x1);
+    scan_row(span.y, x0, x1);
+    if (span.y + 1 < rows) scan_row(span.y + 1, x0, x1);
+}
+
+bool Board::is_open_zero(const size_t i) const
+{
+    return !is_revealed(i) && !is_flagged(i) && !is_mine(i) && mines_around(i) == 0;
+}
+
+int Board::push_run(const int x, const int y)
+{
+    const size_t row = index(0, y);
+
+    int x0 = x;
+    while (x0 > 0 && is_open_zero(row + x0 - 1))
+    {
+        reveal_safe(row + --x0);
+    }
+
+    int x1 = x;
+    while (x1 + 1 < cols && is_open_zero(row + x1 + 1))
+    {
+        reveal_safe(row + ++x1);
+    }
+
+    push_span({y, x0, x1});
+    return x1;
+}
+
+void Board::push_span(const span_t span)
+{
+    if (spans.size() < max_spans)
+    {
+        spans.push_back(span);
+        return;
+    }
+
+    // The run is already revealed, rescanning its row finds it again
+    if (rescan_y >= rescan_end)
+    {
+        rescan_y = span.y;
+        rescan_end = span.y + 1;
+        rescan_x = 0;
+        return;
+    }
+
+    if (span.y <= rescan_y)
+    {
+        rescan_y = span.y;
+        rescan_x = 0;
+    }
+    rescan_end = std::max(rescan_end, span.y + 1);
+}
+
+size_t Board::rescan_row()
+{
+    const int y = rescan_y;
+    const size_t row = index(0, y);
+    const int start = rescan_x;
+
+    // Runs already expanded are queued again too, expanding them finds nothing left to open
+    int x = start;
+    while (x < cols)
+    {
+        const size_t i = row + x;
+        if (!is_revealed(i) || is_mine(i) || mines_around(i) != 0)
+        {
+            ++x;
+            continue;
+        }
+
+        if (spans.size() >= max_spans)
+        {
+            rescan_x = x;
+            return static_cast<size_t>(x - start);
+        }
+
+        int x1 = x;
+        while (x1 + 1 < cols && is_revealed(row + x1 + 1) && !is_mine(row + x1 + 1) &&
+            mines_around(row + x1 + 1) == 0)
+        {
+            ++x1;
+        }
+
+        spans.push_back({y, x, x1});
+        x = x1 + 1;
+    }
+
+    ++rescan_y;
+    rescan_x = 0;
+    return static_cast<size_t>(cols - start);
+}
+
+void Board::scan_row(const int y, const int x0, const int x1)
+{
+    const size_t row = index(0, y);
+
+    for (int x = x0; x <= x1; ++x)
+    {
+        const size_t i = row + x;
+        if (is_revealed(i) || is_flagged(i) || is_mine(i)) continue;
+
+        reveal_safe(i);
+
+        if (mines_around(i) == 0)
+        {
+            x = push_run(x, y);
+        }
+    }
+}
+
+bool Board::check_win() const
+{
+    return state == board_state::WON;
+}
+
+board_state::STATE Board::get_state() const
+{
+    return state;
+}
+
+bool Board::in_bounds(const int x, const int y) const
+{
+    return x >= 0 && x < cols && y >= 0 && y < rows;
+}
+
+void Board::set_seed(const uint64_t _seed)
+{
+    seed = _seed;
+}
+
+void Board::set_safe_radius(const int _safe_radius)
+{
+    safe_radius = _safe_radius;
+}
+
+int Board::get_cols() const
+{
+    return cols;
+}
+
+int Board::get_rows() const
+{
+    return rows;
+}
+
+int Board::get_mines() const
+{
+    return amount_of_mines;
+}
+
+bool Board::is_generated() const
+{
+    return is_gen;
+}
+
+uint64_t Board::get_seed() const
+{
+    return seed;
+}
+
+void Board::set_track_dirty(const bool _track_dirty)
+{
+    track_dirty = _track_dirty;
+    clear_dirty();
+}
+
+const std::vector<uint32_t>& Board::get_dirty() const
+{
+    return dirty;
+}
+
+bool Board::is_dirty_overflow() const
+{
+    return dirty_overflow;
+}
+
+bool Board::get_dirty_range(size_t& lo, size_t& hi) const
+{
+    if (dirty_lo > dirty_hi) return false;
+
+    lo = dirty_lo;
+    hi = dirty_hi;
+    return true;
+}
+
+void Board::clear_dirty()
+{
+    dirty.clear();
+    dirty_overflow = false;
+    dirty_lo = SIZE_MAX;
+    dirty_hi = 0;
+}
+
+size_t Board::get_revealed_safe() const
+{
+    return revealed_safe;
+}
+
+size_t Board::get_safe_cells() const
+{
+    return safe_cells;
+}
+
+size_t Board::get_flag_count() const
+{
+    return flag_count;
+}
+
+size_t Board::get_correct_flags() const
+{
+    return correct_flags;
+}
+
+size_t Board::memory_usage() const
+{
+    return (mine_bits.capacity() + revealed_bits.capacity() + flagged_bits.capacity()) * sizeof(uint64_t) +
+        counts.capacity() * sizeof(uint8_t) + spans.capacity() * sizeof(span_t);
+}
+
+size_t Board::memory_estimate(const int _cols, const int _rows)
+{
+    const size_t cells = static_cast<size_t>(_cols) * static_cast<size_t>(_rows);
+
+    return 3 * ((cells + 63) / 64) * sizeof(uint64_t) + ((cells + 1) / 2) * sizeof(uint8_t) +
+        span_limit(_cols, _rows) * sizeof(span_t);
+}
+
+size_t Board::span_limit(const int _cols, const int _rows)
+{
+    return SPANS_PER_EDGE * static_cast<size_t>(std::max(0, _cols) + std::max(0, _rows)) + 64;
+}
+
+void Board::accumulate_row(const int y, const int block, uint32_t* open, uint32_t* flags) const
+{
+    const size_t begin = index(0, y);
+    const size_t width = static_cast<size_t>(cols);
+    const size_t step = static_cast<size_t>(block > 0 ? block : 1);
+
+    for_each_set(revealed_bits, begin, width, [&](const size_t x) { ++open[x / step]; });
+    for_each_set(flagged_bits, begin, width, [&](const size_t x) { ++flags[x / step]; });
+}
+
+void Board::set_mines_around(const size_t i, const unsigned int count)
+{
+    const unsigned int shift = (i & 1) * 4;
+    counts[i >> 1] = static_cast<uint8_t>((counts[i >> 1] & ~(0x0F << shift)) | ((count & 0x0F) << shift));
+}
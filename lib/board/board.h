@@ -0,0 +1,254 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SDL-free board engine. Holds the mine layout and the per cell state of a
+// single game so it can be driven headless or by Game.
+//
+// Cells are stored as a structure of arrays: one bit per cell for the mine,
+// revealed and flagged planes and one nibble per cell for the neighbour count.
+// Cell (x, y) lives at index y * cols + x in every plane.
+
+namespace board_state
+{
+    enum STATE
+    {
+        PLAYING,
+        WON,
+        LOST,
+    };
+}
+
+class Board
+{
+    // Run of already revealed zero cells [x0, x1] on row y whose neighbours still need opening
+    typedef struct SPAN
+    {
+        int y;
+        int x0;
+        int x1;
+    } span_t;
+
+    std::vector<uint64_t> mine_bits;
+    std::vector<uint64_t> revealed_bits;
+    std::vector<uint64_t> flagged_bits;
+    std::vector<uint8_t> counts;
+
+    // Flood fill work stack, reserved in init and never grown past max_spans so no reveal allocates
+    std::vector<span_t> spans;
+    size_t max_spans{0};
+
+    // Rows [rescan_y, rescan_end) hold runs that did not fit the stack, walked from rescan_x once it drains
+    int rescan_y{0};
+    int rescan_end{0};
+    int rescan_x{0};
+
+    // Stack entries per board edge cell, cascades on sparse boards can queue more and fall back to rescans
+    static constexpr size_t SPANS_PER_EDGE{16};
+
+    // Cells whose revealed / flagged state changed since the last clear_dirty, opt in
+    std::vector<uint32_t> dirty;
+    bool track_dirty{false};
+    bool dirty_overflow{false};
+    // Index bounds of everything marked since the last clear, kept even past MAX_DIRTY
+    size_t dirty_lo{SIZE_MAX};
+    size_t dirty_hi{0};
+
+    // Past this many entries a consumer is better off redrawing everything
+    static constexpr size_t MAX_DIRTY{1u << 16};
+
+    int cols{0};
+    int rows{0};
+    int amount_of_mines{0};
+
+    // Running counters so the game state never needs a board scan
+    size_t safe_cells{0};
+    size_t revealed_safe{0};
+    size_t flag_count{0};
+    size_t correct_flags{0};
+
+    board_state::STATE state{board_state::PLAYING};
+
+    uint64_t seed{0};
+    // Chebyshev radius kept free of mines around the first click, 1 is the classic 3x3 opening
+    int safe_radius{1};
+
+    bool is_gen{false};
+
+public:
+    // Largest supported side, keeps every cell index inside 32 bits
+    static constexpr int MAX_SIZE{16384};
+
+public:
+    Board() = default;
+
+    ~Board() = default;
+
+public:
+    void init(int _cols, int _rows, int _mines);
+
+    // Places exactly `mines` mines with the seeded generator, so the same
+    // (seed, size, safe_x, safe_y) always yields the same board
+    void generate_tiles(int safe_x, int safe_y);
+
+    void set_seed(uint64_t _seed);
+
+    void set_safe_radius(int _safe_radius);
+
+    // Reveals the tile and flood fills empty areas.
+    // Returns the game state right after the reveal, WON as soon as the last safe cell opens.
+    board_state::STATE reveal(int x, int y);
+
+    // Reveals the tile and only queues the flood fill, step_reveal runs it
+    board_state::STATE start_reveal(int x, int y);
+
+    // Runs queued flood fill work for at most budget_us microseconds.
+    // Returns true while part of the cascade is still pending.
+    bool step_reveal(uint32_t budget_us);
+
+    [[nodiscard]] bool is_revealing(void) const;
+
+    void toggle_flag(int x, int y);
+
+    // Queues the flood fill from a revealed zero cell
+    void loop_around_tile(int pos_x, int pos_y);
+
+    [[nodiscard]] bool check_win(void) const;
+
+    [[nodiscard]] board_state::STATE get_state(void) const;
+
+    [[nodiscard]] bool in_bounds(int x, int y) const;
+
+public:
+    [[nodiscard]] size_t index(const int x, const int y) const
+    {
+        return static_cast<size_t>(y) * static_cast<size_t>(cols) + static_cast<size_t>(x);
+    }
+
+    [[nodiscard]] bool is_mine(const size_t i) const { return test_bit(mine_bits, i); }
+
+    [[nodiscard]] bool is_revealed(const size_t i) const { return test_bit(revealed_bits, i); }
+
+    [[nodiscard]] bool is_flagged(const size_t i) const { return test_bit(flagged_bits, i); }
+
+    [[nodiscard]] unsigned int mines_around(const size_t i) const
+    {
+        return (counts[i >> 1] >> ((i & 1) * 4)) & 0x0F;
+    }
+
+    [[nodiscard]] int get_cols(void) const;
+
+    [[nodiscard]] int get_rows(void) const;
+
+    [[nodiscard]] int get_mines(void) const;
+
+    [[nodiscard]] bool is_generated(void) const;
+
+    [[nodiscard]] uint64_t get_seed(void) const;
+
+    void set_track_dirty(bool _track_dirty);
+
+    [[nodiscard]] const std::vector<uint32_t>& get_dirty(void) const;
+
+    // True when more cells changed than get_dirty holds
+    [[nodiscard]] bool is_dirty_overflow(void) const;
+
+    // Smallest index range [lo, hi] holding every changed cell, false when nothing changed
+    bool get_dirty_range(size_t& lo, size_t& hi) const;
+
+    void clear_dirty(void);
+
+    // Adds row y's revealed / flagged cells to open[x / block] and flags[x / block], walks set bits only
+    void accumulate_row(int y, int block, uint32_t* open, uint32_t* flags) const;
+
+    [[nodiscard]] size_t get_revealed_safe(void) const;
+
+    [[nodiscard]] size_t get_safe_cells(void) const;
+
+    [[nodiscard]] size_t get_flag_count(void) const;
+
+    [[nodiscard]] size_t get_correct_flags(void) const;
+
+    [[nodiscard]] size_t memory_usage(void) const;
+
+    // Bytes the planes and the flood fill stack of a cols x rows board will take
+    [[nodiscard]] static size_t memory_estimate(int _cols, int _rows);
+
+private:
+    static bool test_bit(const std::vector<uint64_t>& plane, const size_t i)
+    {
+        return (plane[i >> 6] >> (i & 63)) & 1u;
+    }
+
+    static void set_bit(std::vector<uint64_t>& plane, const size_t i)
+    {
+        plane[i >> 6] |= uint64_t{1} << (i & 63);
+    }
+
+    void mark_dirty(const size_t i)
+    {
+        if (!track_dirty) return;
+
+        dirty_lo = i < dirty_lo ? i : dirty_lo;
+        dirty_hi = i > dirty_hi ? i : dirty_hi;
+
+        if (dirty_overflow) return;
+
+        if (dirty.size() < MAX_DIRTY)
+        {
+            dirty.push_back(static_cast<uint32_t>(i));
+        }
+        else
+        {
+            dirty_overflow = true;
+        }
+    }
+
+    // Marks a safe cell revealed and keeps the win counter in sync
+    void reveal_safe(const size_t i)
+    {
+        set_bit(revealed_bits, i);
+        mark_dirty(i);
+        if (++revealed_safe == safe_cells) state = board_state::WON;
+    }
+
+    static void flip_bit(std::vector<uint64_t>& plane, const size_t i)
+    {
+        plane[i >> 6] ^= uint64_t{1} << (i & 63);
+    }
+
+    void set_mines_around(size_t i, unsigned int count);
+
+    [[nodiscard]] static size_t span_limit(int _cols, int _rows);
+
+    // Zero cell that can still join a flood run
+    [[nodiscard]] bool is_open_zero(size_t i) const;
+
+    // Grows the revealed zero cell (x, y) into a full run along its row and queues it, returns its last x
+    int push_run(int x, int y);
+
+    // Queues the span, or records its row for a rescan when the stack is full
+    void push_span(span_t span);
+
+    // Queues the revealed zero runs of the next rescan row, stops early when the stack fills.
+    // Returns the cells looked at.
+    size_t rescan_row(void);
+
+    // Expands one queued span, or rescans a row once the stack is empty. Returns the cells looked at.
+    size_t fill_step(void);
+
+    // Opens every closed safe cell of row y in [x0, x1] and queues the zero runs it finds
+    void scan_row(int y, int x0, int x1);
+
+    // Expands one queued span
+    void expand_span(void);
+};
+
+#endif //BOARD_H
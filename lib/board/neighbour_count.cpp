@@ -0,0 +1,378 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "neighbour_count.h"
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NEIGHBOUR_COUNT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(NEIGHBOUR_COUNT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+namespace
+{
+    // Extra bytes after every row buffer so vector loads never run past the end
+    constexpr int ROW_PADDING{32};
+
+    typedef struct ROW_KERNEL
+    {
+        // h[x] = b[x - 1] + b[x] + b[x + 1], b is padded by one zero byte on each side
+        void (*horizontal)(const uint8_t* b, uint8_t* h, int n);
+        // c[x] = above[x] + mid[x] + below[x] - self[x], 0 when self[x] is a mine
+        void (*vertical)(const uint8_t* above, const uint8_t* mid, const uint8_t* below,
+                         const uint8_t* self, uint8_t* c, int n);
+        // out[k] = c[2k] | c[2k + 1] << 4 for every full pair
+        void (*pack)(const uint8_t* c, uint8_t* out, int pairs);
+    } row_kernel_t;
+
+    // Spreads the 8 bits of a byte to 8 bytes of 0 / 1, low bit first
+    struct UNPACK_TABLE
+    {
+        uint64_t bytes[256];
+
+        UNPACK_TABLE()
+        {
+            for (int v = 0; v < 256; ++v)
+            {
+                uint64_t spread = 0;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    spread |= static_cast<uint64_t>((v >> bit) & 1) << (bit * 8);
+                }
+                bytes[v] = spread;
+            }
+        }
+    };
+
+    const UNPACK_TABLE unpack_table;
+
+    // 64 bits of the plane starting at an arbitrary bit position
+    uint64_t load_bits(const uint64_t* plane, const size_t words, const size_t bit)
+    {
+        const size_t word = bit >> 6;
+        const unsigned shift = bit & 63;
+
+        uint64_t value = word < words ? plane[word] >> shift : 0;
+        if (shift && word + 1 < words)
+        {
+            value |= plane[word + 1] << (64 - shift);
+        }
+        return value;
+    }
+
+    // Writes row y as one byte per cell into b[1 .. cols], b[0] and b[cols + 1] stay 0
+    void unpack_row(const uint64_t* plane, const size_t words, const int cols, const int y, uint8_t* b)
+    {
+        const size_t start = static_cast<size_t>(y) * static_cast<size_t>(cols);
+        uint8_t* out = b + 1;
+
+        int x = 0;
+        for (; x + 64 <= cols; x += 64)
+        {
+            uint64_t bits = load_bits(plane, words, start + x);
+            for (int k = 0; k < 8; ++k)
+            {
+                const uint64_t spread = unpack_table.bytes[bits & 0xFF];
+                std::memcpy(out + x + k * 8, &spread, sizeof(spread));
+                bits >>= 8;
+            }
+        }
+        if (x < cols)
+        {
+            const uint64_t bits = load_bits(plane, words, start + x);
+            for (int k = 0; x + k < cols; ++k)
+            {
+                out[x + k] = static_cast<uint8_t>((bits >> k) & 1);
+            }
+        }
+        out[cols] = 0;
+    }
+
+    void horizontal_scalar(const uint8_t* b, uint8_t* h, const int n)
+    {
+        for (int x = 0; x < n; ++x)
+        {
+            h[x] = static_cast<uint8_t>(b[x] + b[x + 1] + b[x + 2]);
+        }
+    }
+
+    void vertical_scalar(const uint8_t* above, const uint8_t* mid, const uint8_t* below,
+                         const uint8_t* self, uint8_t* c, const int n)
+    {
+        for (int x = 0; x < n; ++x)
+        {
+            c[x] = static_cast<uint8_t>((above[x] + mid[x] + below[x] - self[x]) & (self[x] - 1));
+        }
+    }
+
+    void pack_scalar(const uint8_t* c, uint8_t* out, const int pairs)
+    {
+        for (int k = 0; k < pairs; ++k)
+        {
+            out[k] = static_cast<uint8_t>(c[2 * k] | (c[2 * k + 1] << 4));
+        }
+    }
+
+#if defined(NEIGHBOUR_COUNT_X86)
+    void horizontal_sse2(const uint8_t* b, uint8_t* h, const int n)
+    {
+        int x = 0;
+        for (; x + 16 <= n; x += 16)
+        {
+            const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+            const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x + 1));
+            const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x + 2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(h + x), _mm_add_epi8(_mm_add_epi8(l, m), r));
+        }
+        horizontal_scalar(b + x, h + x, n - x);
+    }
+
+    void vertical_sse2(const uint8_t* above, const uint8_t* mid, const uint8_t* below,
+                       const uint8_t* self, uint8_t* c, const int n)
+    {
+        const __m128i one = _mm_set1_epi8(1);
+
+        int x = 0;
+        for (; x + 16 <= n; x += 16)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + x));
+            const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mid + x));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + x));
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(self + x));
+
+            const __m128i sum = _mm_sub_epi8(_mm_add_epi8(_mm_add_epi8(a, m), b), s);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(c + x), _mm_and_si128(sum, _mm_sub_epi8(s, one)));
+        }
+        vertical_scalar(above + x, mid + x, below + x, self + x, c + x, n - x);
+    }
+
+    void pack_sse2(const uint8_t* c, uint8_t* out, const int pairs)
+    {
+        const __m128i low_byte = _mm_set1_epi16(0x00FF);
+
+        int k = 0;
+        for (; k + 16 <= pairs; k += 16)
+        {
+            // Each 16-bit lane holds a pair, fold the high byte down next to the low nibble
+            const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + 2 * k));
+            const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + 2 * k + 16));
+            const __m128i p0 = _mm_and_si128(_mm_or_si128(v0, _mm_srli_epi16(v0, 4)), low_byte);
+            const __m128i p1 = _mm_and_si128(_mm_or_si128(v1, _mm_srli_epi16(v1, 4)), low_byte);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_packus_epi16(p0, p1));
+        }
+        pack_scalar(c + 2 * k, out + k, pairs - k);
+    }
+
+    TARGET_AVX2 void horizontal_avx2(const uint8_t* b, uint8_t* h, const int n)
+    {
+        int x = 0;
+        for (; x + 32 <= n; x += 32)
+        {
+            const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x));
+            const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x + 1));
+            const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x + 2));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(h + x), _mm256_add_epi8(_mm256_add_epi8(l, m), r));
+        }
+        horizontal_scalar(b + x, h + x, n - x);
+    }
+
+    TARGET_AVX2 void vertical_avx2(const uint8_t* above, const uint8_t* mid, const uint8_t* below,
+                                   const uint8_t* self, uint8_t* c, const int n)
+    {
+        const __m256i one = _mm256_set1_epi8(1);
+
+        int x = 0;
+        for (; x + 32 <= n; x += 32)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + x));
+            const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mid + x));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + x));
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(self + x));
+
+            const __m256i sum = _mm256_sub_epi8(_mm256_add_epi8(_mm256_add_epi8(a, m), b), s);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + x), _mm256_and_si256(sum, _mm256_sub_epi8(s, one)));
+        }
+        vertical_scalar(above + x, mid + x, below + x, self + x, c + x, n - x);
+    }
+
+    TARGET_AVX2 void pack_avx2(const uint8_t* c, uint8_t* out, const int pairs)
+    {
+        const __m256i low_byte = _mm256_set1_epi16(0x00FF);
+
+        int k = 0;
+        for (; k + 32 <= pairs; k += 32)
+        {
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 2 * k));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 2 * k + 32));
+            const __m256i p0 = _mm256_and_si256(_mm256_or_si256(v0, _mm256_srli_epi16(v0, 4)), low_byte);
+            const __m256i p1 = _mm256_and_si256(_mm256_or_si256(v1, _mm256_srli_epi16(v1, 4)), low_byte);
+            // packus works per 128-bit lane, put the quadwords back in order
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(p0, p1), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), packed);
+        }
+        pack_scalar(c + 2 * k, out + k, pairs - k);
+    }
+#endif
+
+    row_kernel_t get_row_kernel(const neighbour_count::KERNEL kernel)
+    {
+#if defined(NEIGHBOUR_COUNT_X86)
+        switch (kernel)
+        {
+        case neighbour_count::AVX2: return {horizontal_avx2, vertical_avx2, pack_avx2};
+        case neighbour_count::SSE2: return {horizontal_sse2, vertical_sse2, pack_sse2};
+        default: break;
+        }
+#else
+        (void)kernel;
+#endif
+        return {horizontal_scalar, vertical_scalar, pack_scalar};
+    }
+
+    void set_nibble(uint8_t* counts, const size_t i, const uint8_t value)
+    {
+        const unsigned shift = (i & 1) * 4;
+        counts[i >> 1] = static_cast<uint8_t>((counts[i >> 1] & ~(0x0F << shift)) | (value << shift));
+    }
+
+    bool detect_avx2()
+    {
+#if defined(NEIGHBOUR_COUNT_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#elif defined(NEIGHBOUR_COUNT_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        __cpuid(info, 1);
+        const bool os_saves_ymm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 0x6) == 0x6);
+        if (!os_saves_ymm) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+}
+
+namespace neighbour_count
+{
+    KERNEL best_kernel()
+    {
+        static const KERNEL best = is_supported(AVX2) ? AVX2 : (is_supported(SSE2) ? SSE2 : SCALAR);
+        return best;
+    }
+
+    bool is_supported(const KERNEL kernel)
+    {
+        switch (kernel)
+        {
+        case SCALAR: return true;
+#if defined(NEIGHBOUR_COUNT_X86)
+        case SSE2: return true;
+        case AVX2:
+            {
+                static const bool has_avx2 = detect_avx2();
+                return has_avx2;
+            }
+#endif
+        default: return false;
+        }
+    }
+
+    const char* kernel_name(const KERNEL kernel)
+    {
+        switch (kernel)
+        {
+        case SCALAR: return "scalar";
+        case SSE2: return "sse2";
+        case AVX2: return "avx2";
+        default: return "unknown";
+        }
+    }
+
+    void count(const uint64_t* mines, const int cols, const int rows, uint8_t* counts, KERNEL kernel)
+    {
+        if (cols <= 0 || rows <= 0) return;
+        if (!is_supported(kernel)) kernel = SCALAR;
+
+        const row_kernel_t k = get_row_kernel(kernel);
+        const size_t words = (static_cast<size_t>(cols) * static_cast<size_t>(rows) + 63) / 64;
+        const size_t stride = static_cast<size_t>(cols) + 2 + ROW_PADDING;
+
+        // Three rolling rows of unpacked cells, their horizontal sums, one zero row and the output row
+        std::vector<uint8_t> buffer(stride * 8, 0);
+        uint8_t* cells[3] = {buffer.data(), buffer.data() + stride, buffer.data() + 2 * stride};
+        uint8_t* sums[3] = {buffer.data() + 3 * stride, buffer.data() + 4 * stride, buffer.data() + 5 * stride};
+        const uint8_t* zero = buffer.data() + 6 * stride;
+        uint8_t* out = buffer.data() + 7 * stride;
+
+        // cells / sums index 1 is the current row, 0 above and 2 below
+        unpack_row(mines, words, cols, 0, cells[1]);
+        k.horizontal(cells[1], sums[1], cols);
+        if (rows > 1)
+        {
+            unpack_row(mines, words, cols, 1, cells[2]);
+            k.horizontal(cells[2], sums[2], cols);
+        }
+
+        for (int y = 0; y < rows; ++y)
+        {
+            const uint8_t* above = y > 0 ? sums[0] : zero;
+            const uint8_t* below = y + 1 < rows ? sums[2] : zero;
+            k.vertical(above, sums[1], below, cells[1] + 1, out, cols);
+
+            // Rows start on an odd nibble whenever y * cols is odd
+            size_t i = static_cast<size_t>(y) * static_cast<size_t>(cols);
+            int x = 0;
+            if (i & 1)
+            {
+                set_nibble(counts, i, out[0]);
+                ++x;
+                ++i;
+            }
+
+            const int pairs = (cols - x) / 2;
+            k.pack(out + x, counts + (i >> 1), pairs);
+            x += pairs * 2;
+            i += static_cast<size_t>(pairs) * 2;
+
+            if (x < cols)
+            {
+                set_nibble(counts, i, out[x]);
+            }
+
+            // Roll the window down one row
+            uint8_t* cell_row = cells[0];
+            cells[0] = cells[1];
+            cells[1] = cells[2];
+            cells[2] = cell_row;
+
+            uint8_t* sum_row = sums[0];
+            sums[0] = sums[1];
+            sums[1] = sums[2];
+            sums[2] = sum_row;
+
+            if (y + 2 < rows)
+            {
+                unpack_row(mines, words, cols, y + 2, cells[2]);
+                k.horizontal(cells[2], sums[2], cols);
+            }
+        }
+    }
+}
@@ -0,0 +1,37 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef NEIGHBOUR_COUNT_H
+#define NEIGHBOUR_COUNT_H
+
+#include <cstdint>
+
+// Computes every neighbour count of a board in one pass from the packed mine
+// plane. Rows are unpacked to one byte per cell and summed with shifted loads:
+// a horizontal 3-sum per row, then the 3-sum of three rolling rows minus the
+// cell itself. Mines get a count of 0.
+namespace neighbour_count
+{
+    enum KERNEL
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+
+        KERNEL_COUNT,
+    };
+
+    // Fastest kernel the running CPU supports, detected once
+    KERNEL best_kernel(void);
+
+    bool is_supported(KERNEL kernel);
+
+    const char* kernel_name(KERNEL kernel);
+
+    // mines: bit i set for a mine at index i = y * cols + x
+    // counts: (cols * rows + 1) / 2 bytes, nibble i & 1 of byte i / 2 gets the count of cell i
+    void count(const uint64_t* mines, int cols, int rows, uint8_t* counts, KERNEL kernel);
+}
+
+#endif //NEIGHBOUR_COUNT_H
@@ -0,0 +1,70 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// xoshiro256** seeded through splitmix64. Same seed, same sequence on every
+// platform, which is what makes a board reproducible from its seed.
+class Rng
+{
+    uint64_t s[4]{};
+
+public:
+    explicit Rng(uint64_t seed = 0)
+    {
+        reseed(seed);
+    }
+
+    void reseed(uint64_t seed)
+    {
+        for (auto& word : s)
+        {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next()
+    {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+
+        return result;
+    }
+
+    // Unbiased value in [0, bound)
+    uint64_t bounded(const uint64_t bound)
+    {
+        if (bound <= 1) return 0;
+
+        const uint64_t threshold = (0 - bound) % bound;
+        while (true)
+        {
+            const uint64_t r = next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+
+private:
+    static uint64_t rotl(const uint64_t x, const int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif //RNG_H
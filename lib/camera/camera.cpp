@@ -0,0 +1,166 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Camera::set_view(const int w, const int h)
+{
+    view_w = w;
+    view_h = h;
+}
+
+void Camera::set_zoom_limits(const float _min_zoom, const float _max_zoom)
+{
+    min_zoom = _min_zoom;
+    max_zoom = _max_zoom;
+    zoom = std::clamp(zoom, min_zoom, max_zoom);
+}
+
+void Camera::reset(const int cols, const int rows)
+{
+    zoom = std::clamp(1.0f, min_zoom, max_zoom);
+
+    const float grid_w = static_cast<float>(cols) * pitch - (pitch - cell_size);
+    const float grid_h = static_cast<float>(rows) * pitch - (pitch - cell_size);
+
+    pos_x = (grid_w - static_cast<float>(view_w) / zoom) * 0.5f;
+    pos_y = (grid_h - static_cast<float>(view_h) / zoom) * 0.5f;
+}
+
+void Camera::pan(const float screen_dx, const float screen_dy)
+{
+    pos_x += screen_dx / zoom;
+    pos_y += screen_dy / zoom;
+}
+
+void Camera::center_on(const float world_x, const float world_y)
+{
+    pos_x = world_x - static_cast<float>(view_w) * 0.5f / zoom;
+    pos_y = world_y - static_cast<float>(view_h) * 0.5f / zoom;
+}
+
+void Camera::zoom_at(const float factor, const float screen_x, const float screen_y)
+{
+    const float world_x = pos_x + screen_x / zoom;
+    const float world_y = pos_y + screen_y / zoom;
+
+    zoom = std::clamp(zoom * factor, min_zoom, max_zoom);
+
+    pos_x = world_x - screen_x / zoom;
+    pos_y = world_y - screen_y / zoom;
+}
+
+void Camera::clamp_to(const int cols, const int rows)
+{
+    const float grid_w = static_cast<float>(cols) * pitch;
+    const float grid_h = static_cast<float>(rows) * pitch;
+
+    // Allow scrolling until half a view past either edge
+    const float half_w = static_cast<float>(view_w) * 0.5f / zoom;
+    const float half_h = static_cast<float>(view_h) * 0.5f / zoom;
+
+    pos_x = std::clamp(pos_x, -half_w, std::max(-half_w, grid_w - half_w));
+    pos_y = std::clamp(pos_y, -half_h, std::max(-half_h, grid_h - half_h));
+}
+
+float Camera::fit_zoom(const int cols, const int rows) const
+{
+    if (cols <= 0 || rows <= 0 || view_w <= 0 || view_h <= 0) return 1.0f;
+
+    return std::min(static_cast<float>(view_w) / (static_cast<float>(cols) * pitch),
+                    static_cast<float>(view_h) / (static_cast<float>(rows) * pitch));
+}
+
+view_rect_t Camera::cell_rect(const int x, const int y) const
+{
+    return {
+        (static_cast<float>(x) * pitch - pos_x) * zoom,
+        (static_cast<float>(y) * pitch - pos_y) * zoom,
+        cell_size * zoom,
+        cell_size * zoom
+    };
+}
+
+view_rect_t Camera::to_screen(const view_rect_t world) const
+{
+    return {(world.x - pos_x) * zoom, (world.y - pos_y) * zoom, world.w * zoom, world.h * zoom};
+}
+
+cell_range_t Camera::visible_cells(const int cols, const int rows) const
+{
+    const float world_x0 = pos_x;
+    const float world_y0 = pos_y;
+    const float world_x1 = pos_x + static_cast<float>(view_w) / zoom;
+    const float world_y1 = pos_y + static_cast<float>(view_h) / zoom;
+
+    const int first_x = static_cast<int>(std::floor(world_x0 / pitch));
+    const int first_y = static_cast<int>(std::floor(world_y0 / pitch));
+    const int last_x = static_cast<int>(std::floor(world_x1 / pitch));
+    const int last_y = static_cast<int>(std::floor(world_y1 / pitch));
+
+    return {
+        std::max(0, first_x),
+        std::max(0, first_y),
+        std::min(cols - 1, last_x),
+        std::min(rows - 1, last_y)
+    };
+}
+
+bool Camera::cell_at(const float screen_x, const float screen_y, const int cols, const int rows, int& x, int& y) const
+{
+    const float world_x = pos_x + screen_x / zoom;
+    const float world_y = pos_y + screen_y / zoom;
+    if (world_x <= 0.0f || world_y <= 0.0f) return false;
+
+    const int cx = static_cast<int>(world_x / pitch);
+    const int cy = static_cast<int>(world_y / pitch);
+    if (cx >= cols || cy >= rows) return false;
+
+    // Strict cell edges, anything past cell_size is the gap to the next cell
+    const float in_x = world_x - static_cast<float>(cx) * pitch;
+    const float in_y = world_y - static_cast<float>(cy) * pitch;
+    if (in_x <= 0.0f || in_x >= cell_size || in_y <= 0.0f || in_y >= cell_size) return false;
+
+    x = cx;
+    y = cy;
+    return true;
+}
+
+float Camera::get_zoom() const
+{
+    return zoom;
+}
+
+float Camera::get_x() const
+{
+    return pos_x;
+}
+
+float Camera::get_y() const
+{
+    return pos_y;
+}
+
+float Camera::get_pitch() const
+{
+    return pitch;
+}
+
+float Camera::get_cell_size() const
+{
+    return cell_size;
+}
+
+int Camera::get_view_w() const
+{
+    return view_w;
+}
+
+int Camera::get_view_h() const
+{
+    return view_h;
+}
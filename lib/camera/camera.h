@@ -0,0 +1,100 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+// SDL-free view transform for the board grid. World space has cell (x, y)
+// at (x * pitch, y * pitch) with pitch = cell size + gap, screen space is
+// (world - position) * zoom.
+
+typedef struct VIEW_RECT
+{
+    float x;
+    float y;
+    float w;
+    float h;
+} view_rect_t;
+
+// Inclusive cell range, empty when x0 > x1 or y0 > y1
+typedef struct CELL_RANGE
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+} cell_range_t;
+
+class Camera
+{
+    float cell_size;
+    float pitch;
+
+    float pos_x{0.0f};
+    float pos_y{0.0f};
+    float zoom{1.0f};
+
+    float min_zoom{0.08f};
+    float max_zoom{4.0f};
+
+    int view_w{0};
+    int view_h{0};
+
+public:
+    Camera(const float _cell_size, const float _gap) : cell_size{_cell_size}, pitch{_cell_size + _gap}
+    {
+    };
+
+    ~Camera() = default;
+
+public:
+    void set_view(int w, int h);
+
+    void set_zoom_limits(float _min_zoom, float _max_zoom);
+
+    // Zoom 1 with the whole cols x rows grid centred in the view
+    void reset(int cols, int rows);
+
+    void pan(float screen_dx, float screen_dy);
+
+    // Moves the view so the world point ends up in its centre
+    void center_on(float world_x, float world_y);
+
+    // Scales the zoom while keeping the world point under (screen_x, screen_y) in place
+    void zoom_at(float factor, float screen_x, float screen_y);
+
+    // Keeps at least part of the grid on screen
+    void clamp_to(int cols, int rows);
+
+    // Zoom at which the whole cols x rows grid fits the view
+    [[nodiscard]] float fit_zoom(int cols, int rows) const;
+
+    [[nodiscard]] view_rect_t cell_rect(int x, int y) const;
+
+    // Screen rect of a world space rect
+    [[nodiscard]] view_rect_t to_screen(view_rect_t world) const;
+
+    // Cells that overlap the view, clipped to the board
+    [[nodiscard]] cell_range_t visible_cells(int cols, int rows) const;
+
+    // Cell under a screen position, false for gaps and positions off the board
+    [[nodiscard]] bool cell_at(float screen_x, float screen_y, int cols, int rows, int& x, int& y) const;
+
+public:
+    [[nodiscard]] float get_zoom(void) const;
+
+    [[nodiscard]] float get_x(void) const;
+
+    [[nodiscard]] float get_y(void) const;
+
+    [[nodiscard]] float get_pitch(void) const;
+
+    [[nodiscard]] float get_cell_size(void) const;
+
+    [[nodiscard]] int get_view_w(void) const;
+
+    [[nodiscard]] int get_view_h(void) const;
+};
+
+#endif //CAMERA_H
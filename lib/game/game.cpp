@@ -4,13 +4,18 @@
 
 #include "game.h"
 
+#include <trace.h>
+
 #include <SDL2/SDL_log.h>
 #include <SDL2/SDL_mouse.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <string>
 #include <limits>
 #include <memory>
-#include <queue>
 
 static SDL_Color current_start_color = platform::font::color::BG;
 static SDL_Color current_quit_color = platform::font::color::BG;
@@ -18,24 +23,79 @@ static SDL_Color current_quit_color = platform::font::color::BG;
 static SDL_FRect current_start_rect;
 static SDL_FRect current_quit_rect;
 
-static float grid_w;
-static float grid_h;
+static bool ignore_left_click_until_release{false};
+static bool init_generation{false};
+static bool is_lost{false};
+
+static constexpr int MENU_BTN_W{200};
+static constexpr int MENU_BTN_H{100};
+static constexpr float MENU_BTN_RADIUS{10.0f};
+
+static constexpr float MINE_RADIUS{20.0f};
+static constexpr float FLAG_RADIUS{10.0f};
+static constexpr float FLAG_THICKNESS{1.5f};
+
+static constexpr SDL_Color PAUSE_DIM{0, 0, 0, 160};
+
+static constexpr float OVERLAY_X{8.0f};
+static constexpr float OVERLAY_Y{8.0f};
+static constexpr float OVERLAY_W{360.0f};
+static constexpr float OVERLAY_LINE{15.0f};
+static constexpr float OVERLAY_GRAPH_H{60.0f};
+// Graph scale and the reference line, one 60 Hz frame
+static constexpr float OVERLAY_GRAPH_MS{33.4f};
+static constexpr float OVERLAY_BUDGET_MS{16.7f};
+static constexpr SDL_Color OVERLAY_BG{0, 0, 0, 190};
+static constexpr SDL_Color OVERLAY_TEXT{230, 230, 230, 255};
+static constexpr SDL_Color OVERLAY_BAR{119, 203, 185, 255};
+static constexpr SDL_Color OVERLAY_SLOW{196, 41, 41, 255};
+
+// Smallest on screen cell that still gets its number drawn
+static constexpr float MIN_NUMBER_CELL{16.0f};
+
+static SDL_Color number_color(const unsigned int mines_around)
+{
+    const uint8_t radiant = mines_around * 30;
+    return {
+        static_cast<uint8_t>(41 + radiant),
+        static_cast<uint8_t>(184 + radiant),
+        static_cast<uint8_t>(255 + radiant),
+        255
+    };
+}
+
+void Game::warm_render_caches() const
+{
+    renderer_utils->cache_rounded_rect(MENU_BTN_W, MENU_BTN_H, MENU_BTN_RADIUS);
+    renderer_utils->cache_rounded_rect(platform::game::block::SIZE, platform::game::block::SIZE, MINE_RADIUS);
+    renderer_utils->cache_ring(FLAG_RADIUS, FLAG_THICKNESS);
 
-static std::vector<std::vector<block_stats_t>> board;
+    char txt[2] = {0, 0};
+    for (unsigned int mines_around = 1; mines_around <= 8; ++mines_around)
+    {
+        txt[0] = static_cast<char>('0' + mines_around);
+        renderer_utils->cache_text(txt, number_color(mines_around));
+    }
 
-static int amount_of_mines{0};
+    renderer_utils->cache_text("Start", platform::font::color::MAIN);
+    renderer_utils->cache_text("Quit", platform::font::color::MAIN);
+    renderer_utils->cache_text("Paused", platform::font::color::MAIN);
 
-static bool ignore_left_click_until_release{false};
-static bool init_generation{false};
-static bool is_gen{false};
+    // Overlay glyphs, so toggling it on does not rasterise inside a frame
+    for (char c = '!'; c <= '~'; ++c)
+    {
+        txt[0] = c;
+        renderer_utils->cache_text(txt, OVERLAY_TEXT);
+    }
+}
 
 platform::game_state::MENU_ACTION Game::start_menu(SDL_Window* window, const mouse_pos pos) const
 {
-    constexpr int btn_h = {100};
-    constexpr int btn_w = {200};
+    constexpr int btn_h = MENU_BTN_H;
+    constexpr int btn_w = MENU_BTN_W;
     constexpr int btn_offset = {20};
 
-    constexpr int border_r = {10};
+    constexpr float border_r = MENU_BTN_RADIUS;
 
     constexpr int middle_x = (platform::window::WIDTH - btn_w) / 2;
     constexpr int middle_y = (platform::window::HEIGHT - btn_h) / 2;
@@ -46,7 +106,7 @@ platform::game_state::MENU_ACTION Game::start_menu(SDL_Window* window, const mou
     renderer_utils->draw_rounded_rect(start_btn, border_r, current_start_color);
     renderer_utils->draw_rounded_rect(quit_btn, border_r, current_quit_color);
 
-    SDL_SetWindowTitle(window, platform::window::TITLE);
+    set_title(window, platform::window::TITLE);
 
     static constexpr int font_offset = 30;
     renderer_utils->draw_txt_centered({
@@ -120,33 +180,75 @@ platform::game_state::MENU_ACTION Game::game_loop(const mouse_pos pos, SDL_Windo
                                                   const double elapsed_time,
                                                   const platform::game::board::board_settings_t board_size)
 {
-    char temp[sizeof(std::to_string(DBL_MAX))];
+    TRACE_ZONE("game_loop");
 
-    get_time_stamp(elapsed_time, temp);
+    char time_stamp[32];
+    get_time_stamp(elapsed_time, time_stamp, sizeof(time_stamp));
 
     if (init_generation)
     {
+        PROFILE_SCOPE("board init");
         board_init(board_size);
         init_generation = false;
     }
 
-    generate_grid();
+    // Candidates for a no-guess board, one batch per frame
+    if (generator.is_running())
+    {
+        PROFILE_SCOPE("no-guess");
+        update_generator();
+    }
+
+    // Large cascades spread over several frames so they never block one
+    {
+        PROFILE_SCOPE("reveal");
+        board.step_reveal(reveal_budget_us);
+    }
+
+    // Works through the cells last frame's reveals changed
+    {
+        PROFILE_SCOPE("solver");
+        solver.step(board, platform::game::solver::BUDGET_US);
+    }
+
+    update_camera(pos, elapsed_time);
+
+    {
+        PROFILE_SCOPE("probability");
+        update_probabilities();
+    }
+
+    {
+        PROFILE_SCOPE("draw");
+        generate_grid();
+        draw_heat_map();
+        draw_hint();
+        draw_minimap();
+    }
+
+    if (board.is_generated())
+    {
+        char title[sizeof(window_title)];
+        std::snprintf(title, sizeof(title), "%s %s", platform::window::TITLE, time_stamp);
+        set_title(window, title);
+    }
 
-    if (is_gen)
+    // The first click also generates the board
+    board_state::STATE state;
     {
-        const std::string title = std::string(platform::window::TITLE) + " " + temp;
-        SDL_SetWindowTitle(window, title.c_str());
+        PROFILE_SCOPE("click");
+        solver_action();
+        state = grid_mouse_action(pos);
     }
 
-    // If true, you lost the game
-    if (grid_mouse_action(pos))
+    if (state == board_state::LOST)
     {
         // TODO: Add a wait before going to the title screen or have a more user friendly output that you lost the game
         return platform::game_state::TITLE;
     }
 
-    // If true, you won the game
-    if (check_win())
+    // Raised by the board on the click that reveals the last safe cell
+    if (state == board_state::WON)
     {
         // TODO: check if the time is in the best of 10, and if it is return to the platform::game_state::SCORE
         SDL_Log("You won the game!");
@@ -162,6 +264,171 @@ platform::game_state::MENU_ACTION Game::game_loop(const mouse_pos pos, SDL_Windo
     return platform::game_state::PLAYING;
 }
 
+void Game::pause_screen(SDL_Window* window)
+{
+    generate_grid();
+    draw_minimap();
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    renderer_utils->draw_rect({
+                                  0.0f, 0.0f,
+                                  static_cast<float>(camera.get_view_w()), static_cast<float>(camera.get_view_h())
+                              }, PAUSE_DIM);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    renderer_utils->draw_txt_centered({
+                                          0, camera.get_view_h() / 3,
+                                          camera.get_view_w(), camera.get_view_h() / 3
+                                      },
+                                      platform::font::color::MAIN, "Paused", 1);
+
+    set_title(window, platform::window::TITLE);
+}
+
+void Game::draw_profiler_overlay()
+{
+    if (IS_PRESSED(platform::input::F3))
+    {
+        show_profiler = !show_profiler;
+    }
+
+    // Read before the overlay adds its own calls
+    const uint32_t draw_calls = renderer_utils->get_draw_calls();
+    renderer_utils->reset_frame_stats();
+
+    if (!show_profiler) return;
+
+    const Profiler& profiler = Profiler::get();
+    const std::vector<Profiler::series_t>& series = profiler.get_series();
+
+    int lines = 3 + (show_heat ? 1 : 0) + (no_guess ? 1 : 0);
+    for (const auto& s : series)
+    {
+        if (s.count > 0) ++lines;
+    }
+
+    const float graph_y = OVERLAY_Y + 6.0f + static_cast<float>(lines) * OVERLAY_LINE;
+    renderer_utils->batch_rect({
+                                   OVERLAY_X, OVERLAY_Y, OVERLAY_W,
+                                   static_cast<float>(lines) * OVERLAY_LINE + OVERLAY_GRAPH_H + 16.0f
+                               }, OVERLAY_BG);
+
+    // Columns start at fixed offsets, glyph widths vary
+    constexpr float columns[5] = {
+        OVERLAY_X + 6.0f, OVERLAY_X + 110.0f, OVERLAY_X + 170.0f, OVERLAY_X + 230.0f, OVERLAY_X + 290.0f
+    };
+    constexpr float text_h = OVERLAY_LINE - 3.0f;
+    char buffer[64];
+
+    float y = OVERLAY_Y + 4.0f;
+    renderer_utils->batch_glyphs(columns[0], y, text_h, OVERLAY_TEXT, "stage ms");
+    renderer_utils->batch_glyphs(columns[1], y, text_h, OVERLAY_TEXT, "p50");
+    renderer_utils->batch_glyphs(columns[2], y, text_h, OVERLAY_TEXT, "p95");
+    renderer_utils->batch_glyphs(columns[3], y, text_h, OVERLAY_TEXT, "p99");
+    renderer_utils->batch_glyphs(columns[4], y, text_h, OVERLAY_TEXT, "allocs");
+
+    for (size_t i = 0; i < series.size(); ++i)
+    {
+        if (series[i].count == 0) continue;
+        y += OVERLAY_LINE;
+
+        const int id = static_cast<int>(i);
+        renderer_utils->batch_glyphs(columns[0], y, text_h, OVERLAY_TEXT, series[i].name);
+
+        const float values[3] = {
+            profiler.percentile(id, 0.50f), profiler.percentile(id, 0.95f), profiler.percentile(id, 0.99f)
+        };
+        for (int c = 0; c < 3; ++c)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%.2f", values[c]);
+            renderer_utils->batch_glyphs(columns[c + 1], y, text_h, OVERLAY_TEXT, buffer);
+        }
+
+        std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(series[i].allocs));
+        renderer_utils->batch_glyphs(columns[4], y, text_h, OVERLAY_TEXT, buffer);
+    }
+
+    // Textures outside Renderer: the retained board image and the minimap
+    const size_t textures = renderer_utils->get_texture_count() + (board_target ? 1 : 0) +
+        (minimap.is_ready() ? 1 : 0);
+
+    y += OVERLAY_LINE;
+    std::snprintf(buffer, sizeof(buffer), "draw calls %u  textures %zu", draw_calls, textures);
+    renderer_utils->batch_glyphs(columns[0], y, text_h, OVERLAY_TEXT, buffer);
+
+    y += OVERLAY_LINE;
+    std::snprintf(buffer, sizeof(buffer), "text cache %llu hits %llu misses",
+                  static_cast<unsigned long long>(renderer_utils->get_text_cache_hits()),
+                  static_cast<unsigned long long>(renderer_utils->get_text_cache_misses()));
+    renderer_utils->batch_glyphs(columns[0], y, text_h, OVERLAY_TEXT, buffer);
+
+    if (show_heat)
+    {
+        // Throughput of the last probability pass
+        const probability_stats_t& stats = probability.get_stats();
+        const double seconds = std::max(stats.ms, 1e-3) / 1000.0;
+        y += OVERLAY_LINE;
+        std::snprintf(buffer, sizeof(buffer), "prob %zu cells %zu comps %.2f ms %.0fk cells/s%s",
+                      stats.frontier_cells, stats.components, stats.ms,
+                      static_cast<double>(stats.frontier_cells) / seconds / 1000.0,
+                      probability.is_exact() ? "" : " ~");
+        renderer_utils->batch_glyphs(columns[0], y, text_h, OVERLAY_TEXT, buffer);
+    }
+
+    if (no_guess)
+    {
+        const no_guess_stats_t& stats = generator.get_stats();
+        y += OVERLAY_LINE;
+        std::snprintf(buffer, sizeof(buffer), "no-guess %llu tries  p50 %.1f p95 %.1f p99 %.1f ms",
+                      static_cast<unsigned long long>(stats.tries), stats.p50_ms, stats.p95_ms, stats.p99_ms);
+        renderer_utils->batch_glyphs(columns[0], y, text_h, OVERLAY_TEXT, buffer);
+    }
+
+    // Frame time graph, newest sample on the right
+    const Profiler::series_t& frame = series[Profiler::FRAME];
+    const float bar_w = (OVERLAY_W - 12.0f) / static_cast<float>(Profiler::HISTORY);
+    const float graph_bottom = graph_y + OVERLAY_GRAPH_H;
+
+    for (int k = 0; k < frame.count; ++k)
+    {
+        const float ms = frame.samples[(frame.head + k) % Profiler::HISTORY];
+        const float h = std::min(1.0f, ms / OVERLAY_GRAPH_MS) * OVERLAY_GRAPH_H;
+        const float x = OVERLAY_X + 6.0f + static_cast<float>(Profiler::HISTORY - frame.count + k) * bar_w;
+
+        renderer_utils->batch_rect({x, graph_bottom - h, bar_w, h}, ms > OVERLAY_BUDGET_MS ? OVERLAY_SLOW : OVERLAY_BAR);
+    }
+
+    const float budget_y = graph_bottom - OVERLAY_BUDGET_MS / OVERLAY_GRAPH_MS * OVERLAY_GRAPH_H;
+    renderer_utils->batch_rect({OVERLAY_X + 6.0f, budget_y, OVERLAY_W - 12.0f, 1.0f}, OVERLAY_TEXT);
+
+    // Untextured geometry follows the draw blend mode
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    renderer_utils->flush_batch();
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+uint32_t Game::idle_timeout_ms(const double elapsed_time) const
+{
+    // Cascades, held pan keys and a catching up minimap need every frame
+    const bool panning = IS_DOWN(platform::input::W) || IS_DOWN(platform::input::A) ||
+        IS_DOWN(platform::input::S) || IS_DOWN(platform::input::D) ||
+        IS_DOWN(platform::input::UP) || IS_DOWN(platform::input::DOWN) ||
+        IS_DOWN(platform::input::LEFT) || IS_DOWN(platform::input::RIGHT);
+
+    if (board.is_revealing() || panning) return 0;
+    if (solver.is_pending() || auto_play || generator.is_running()) return 0;
+    if ((show_minimap || use_lod()) && !minimap.is_complete()) return 0;
+
+    // Otherwise only the clock in the title changes, wake when its text would
+    if (!board.is_generated()) return platform::window::IDLE_WAIT_MS;
+
+    const auto elapsed_ms = static_cast<uint64_t>(elapsed_time * 1000.0);
+    if (elapsed_time < 60) return 10 - static_cast<uint32_t>(elapsed_ms % 10);
+    if (elapsed_time < 3600) return 1000 - static_cast<uint32_t>(elapsed_ms % 1000);
+
+    return std::min<uint32_t>(platform::window::IDLE_WAIT_MS, 60000 - static_cast<uint32_t>(elapsed_ms % 60000));
+}
+
 bool Game::check_hover(const SDL_FRect rect, const mouse_pos pos) const
 {
     bool is_hovering = false;
@@ -181,26 +448,25 @@ bool Game::check_hover(const SDL_FRect rect, const mouse_pos pos) const
 
 void Game::set_cursor(const bool is_hovering) const
 {
-    if (is_hovering)
-    {
-        SDL_Cursor* cursor = SDL_CreateSystemCursor(SDL_SYSTEM_CURSOR_HAND);
-        SDL_SetCursor(cursor);
-    }
-    else
-    {
-        SDL_Cursor* cursor = SDL_CreateSystemCursor(SDL_SYSTEM_CURSOR_ARROW);
-        SDL_SetCursor(cursor);
-    }
+    resources->set_cursor(is_hovering ? SDL_SYSTEM_CURSOR_HAND : SDL_SYSTEM_CURSOR_ARROW);
+}
+
+void Game::set_title(SDL_Window* window, const char* title) const
+{
+    if (std::strncmp(window_title, title, sizeof(window_title)) == 0) return;
+
+    std::snprintf(window_title, sizeof(window_title), "%s", title);
+    SDL_SetWindowTitle(window, window_title);
 }
 
-void Game::get_time_stamp(const double elapsed_time, char* time_stamp) const
+void Game::get_time_stamp(const double elapsed_time, char* time_stamp, const size_t size) const
 {
     if (elapsed_time < 60)
     {
         const int seconds = static_cast<const int>(elapsed_time);
         const int milliseconds = static_cast<const int>((elapsed_time - seconds) * 100.0);
 
-        std::snprintf(time_stamp, sizeof(time_stamp), "(%d:%02d) seconds", seconds, milliseconds);
+        std::snprintf(time_stamp, size, "(%d:%02d) seconds", seconds, milliseconds);
     }
     else if (elapsed_time < 3600)
     {
@@ -208,7 +474,7 @@ void Game::get_time_stamp(const double elapsed_time, char* time_stamp) const
         const int minutes = total / 60;
         const int seconds = total % 60;
 
-        std::snprintf(time_stamp, sizeof(time_stamp), "(%d:%02d) minutes", minutes, seconds);
+        std::snprintf(time_stamp, size, "(%d:%02d) minutes", minutes, seconds);
     }
     else
     {
@@ -216,293 +482,583 @@ void Game::get_time_stamp(const double elapsed_time, char* time_stamp) const
         const int hours = total / 3600;
         const int minutes = (total % 3600) / 60;
 
-        std::snprintf(time_stamp, sizeof(time_stamp), "(%d:%02d) hours", hours, minutes);
+        std::snprintf(time_stamp, size, "(%d:%02d) hours", hours, minutes);
+    }
+}
+
+void Game::board_init(const platform::game::board::board_settings_t board_size)
+{
+    board.init(static_cast<int>(board_size.w), static_cast<int>(board_size.h), static_cast<int>(board_size.mines));
+    board.set_safe_radius(platform::game::board::SAFE_RADIUS);
+    board.set_seed(board_size.seed != 0
+                       ? board_size.seed
+                       : SDL_GetPerformanceCounter() ^ (static_cast<uint64_t>(time(nullptr)) << 32));
+
+    const int cols = board.get_cols();
+    const int rows = board.get_rows();
+
+    int view_w = platform::window::WIDTH;
+    int view_h = platform::window::HEIGHT;
+    SDL_GetRendererOutputSize(renderer, &view_w, &view_h);
+
+    // Starts at 1:1 centred on the board, small boards look exactly as before.
+    // Big boards may zoom out until all of them fits, drawn from the minimap texture by then.
+    camera.set_view(view_w, view_h);
+    camera.set_zoom_limits(std::min(platform::game::camera::MIN_ZOOM, camera.fit_zoom(cols, rows) * 0.9f),
+                           platform::game::camera::MAX_ZOOM);
+    camera.reset(cols, rows);
+    minimap.resize(cols, rows);
+    solver.reset(cols, rows);
+    show_hint = false;
+    auto_play = false;
+    heat_stale = true;
+
+    // A search for the previous board is of no use any more
+    generator.cancel();
+    generator.step();
+    no_guess = board_size.no_guess &&
+        static_cast<uint64_t>(cols) * static_cast<uint64_t>(rows) <= platform::game::board::NO_GUESS_MAX_CELLS;
+    if (board_size.no_guess && !no_guess)
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Board too large for no-guess generation, dealing a regular one");
     }
+    last_frame_time = 0.0;
+
+    is_lost = false;
+    redraw_board = true;
+
+    SDL_Log("Board %dx%d with %d mines uses %.2f MiB, seed %llu", cols, rows, board.get_mines(),
+            static_cast<double>(board.memory_usage()) / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(board.get_seed()));
 }
 
-void Game::board_init(const platform::game::board::board_settings_t board_size) const
+void Game::update_camera(const mouse_pos pos, const double elapsed_time)
 {
-    const int cols = board_size.w;
-    const int rows = board_size.h;
+    int view_w = 0;
+    int view_h = 0;
+    if (SDL_GetRendererOutputSize(renderer, &view_w, &view_h) == 0)
+    {
+        camera.set_view(view_w, view_h);
+    }
 
-    board.assign(rows, std::vector<block_stats_t>(cols));
+    // Frame time drives the keyboard pan, clamped so a stall does not fling the view
+    const float dt = static_cast<float>(std::clamp(elapsed_time - last_frame_time, 0.0, 0.1));
+    last_frame_time = elapsed_time;
 
-    constexpr float cell = platform::game::block::SIZE;
-    constexpr float gap = platform::game::block::OFFSET;
+    float dx = 0.0f;
+    float dy = 0.0f;
+    if (IS_DOWN(platform::input::A) || IS_DOWN(platform::input::LEFT)) dx -= 1.0f;
+    if (IS_DOWN(platform::input::D) || IS_DOWN(platform::input::RIGHT)) dx += 1.0f;
+    if (IS_DOWN(platform::input::W) || IS_DOWN(platform::input::UP)) dy -= 1.0f;
+    if (IS_DOWN(platform::input::S) || IS_DOWN(platform::input::DOWN)) dy += 1.0f;
 
-    grid_w = static_cast<float>(cols) * cell + static_cast<float>(cols - 1) * gap;
-    grid_h = static_cast<float>(rows) * cell + static_cast<float>(rows - 1) * gap;
+    camera.pan(dx * platform::game::camera::PAN_SPEED * dt, dy * platform::game::camera::PAN_SPEED * dt);
+
+    if (IS_DOWN(platform::input::MOUSE_MIDDLE) && !IS_PRESSED(platform::input::MOUSE_MIDDLE))
+    {
+        camera.pan(static_cast<float>(drag_pos.x - pos.x), static_cast<float>(drag_pos.y - pos.y));
+    }
+    drag_pos = pos;
 
-    const float origin_x = (platform::window::WIDTH - grid_w) * 0.5f;
-    const float origin_y = (platform::window::HEIGHT - grid_h) * 0.5f;
+    if (IS_PRESSED(platform::input::M))
+    {
+        show_minimap = !show_minimap;
+    }
 
-    // Generate the table
-    for (int y = 0; y < rows; ++y)
+    // Pressing inside the overlay jumps there, holding keeps following the cursor
+    const SDL_FRect map = minimap_rect();
+    if (!IS_DOWN(platform::input::MOUSE_LEFT))
     {
-        for (int x = 0; x < cols; ++x)
-        {
-            const SDL_FRect rect = {
-                origin_x + x * (cell + gap),
-                origin_y + y * (cell + gap),
-                cell,
-                cell
-            };
-
-            board[y][x].rect = rect;
-            board[y][x].bg = platform::game::block::color::BG;
-            board[y][x].mines_around = 0;
-            board[y][x].is_revealed = false;
-            board[y][x].is_flagged = false;
-            board[y][x].is_mine = false;
-        }
+        minimap_drag = false;
+    }
+    else if (show_minimap && IS_PRESSED(platform::input::MOUSE_LEFT) && check_hover(map, pos))
+    {
+        minimap_drag = true;
+    }
+
+    if (minimap_drag)
+    {
+        const float u = std::clamp((static_cast<float>(pos.x) - map.x) / map.w, 0.0f, 1.0f);
+        const float v = std::clamp((static_cast<float>(pos.y) - map.y) / map.h, 0.0f, 1.0f);
+        camera.center_on(u * static_cast<float>(board.get_cols()) * camera.get_pitch(),
+                         v * static_cast<float>(board.get_rows()) * camera.get_pitch());
+    }
+
+    if (input.wheel != 0)
+    {
+        camera.zoom_at(std::pow(platform::game::camera::ZOOM_STEP, static_cast<float>(input.wheel)),
+                       static_cast<float>(pos.x), static_cast<float>(pos.y));
+    }
+
+    camera.clamp_to(board.get_cols(), board.get_rows());
+
+    // Any camera move invalidates the whole retained image
+    if (camera.get_x() != drawn_x || camera.get_y() != drawn_y || camera.get_zoom() != drawn_zoom)
+    {
+        drawn_x = camera.get_x();
+        drawn_y = camera.get_y();
+        drawn_zoom = camera.get_zoom();
+        redraw_board = true;
     }
+}
 
-    amount_of_mines = board_size.mines;
-    is_gen = false;
+SDL_FRect Game::cell_rect(const int x, const int y) const
+{
+    const view_rect_t rect = camera.cell_rect(x, y);
+    return {rect.x, rect.y, rect.w, rect.h};
 }
 
-void Game::generate_tiles(const int safe_x, const int safe_y) const
+SDL_FRect Game::minimap_rect() const
 {
-    const int rows = static_cast<int>(board.size());
-    const int cols = static_cast<int>(board[0].size());
+    const int cols = std::max(1, board.get_cols());
+    const int rows = std::max(1, board.get_rows());
+
+    const float scale = platform::game::minimap::SIZE / static_cast<float>(std::max(cols, rows));
+    const float w = std::max(1.0f, static_cast<float>(cols) * scale);
+    const float h = std::max(1.0f, static_cast<float>(rows) * scale);
+
+    return {
+        static_cast<float>(camera.get_view_w()) - platform::game::minimap::MARGIN - w,
+        static_cast<float>(camera.get_view_h()) - platform::game::minimap::MARGIN - h,
+        w,
+        h
+    };
+}
 
-    int mines = amount_of_mines;
-    srand(static_cast<unsigned int>(time(nullptr)));
+bool Game::use_lod() const
+{
+    return camera.get_zoom() * camera.get_pitch() < platform::game::camera::LOD_CELL_PX;
+}
 
-    while (mines > 0)
+Game::~Game()
+{
+    if (board_target)
     {
-        const int x = rand() % cols;
-        const int y = rand() % rows;
+        SDL_DestroyTexture(board_target);
+    }
 
-        // TODO: Make sure the surrounding area [3 x 3] dose not have mines as well
-        if (!board[y][x].is_mine && !(x == safe_x && y == safe_y))
-        {
-            board[y][x].is_mine = true;
-            --mines;
-        }
+    delete renderer_utils;
+    delete score_manager;
+}
+
+bool Game::update_board_target()
+{
+    if (!SDL_RenderTargetSupported(renderer)) return false;
+
+    int w = 0;
+    int h = 0;
+    if (SDL_GetRendererOutputSize(renderer, &w, &h) != 0 || w <= 0 || h <= 0) return false;
+
+    if (board_target && w == board_target_w && h == board_target_h) return true;
+
+    if (board_target)
+    {
+        SDL_DestroyTexture(board_target);
     }
 
-    for (int y = 0; y < rows; ++y)
+    board_target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!board_target)
     {
-        for (int x = 0; x < cols; ++x)
-        {
-            if (board[y][x].is_mine) continue;
+        SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to create board render target: %s", SDL_GetError());
+        return false;
+    }
+
+    board_target_w = w;
+    board_target_h = h;
+    redraw_board = true;
+
+    return true;
+}
+
+void Game::draw_cell(const int x, const int y) const
+{
+    const size_t i = board.index(x, y);
+    const SDL_FRect rect = cell_rect(x, y);
+    const float zoom = camera.get_zoom();
+    const bool is_revealed = board.is_revealed(i);
+
+    SDL_Color bg = platform::game::block::color::BG;
+    if (is_revealed)
+    {
+        bg = (board.is_mine(i) && is_lost)
+                 ? platform::game::block::color::LOST_BG
+                 : platform::game::block::color::REVELED_BG;
+    }
 
-            int count = 0;
-            for (int i = -1; i <= 1; ++i)
+    renderer_utils->batch_rect(rect, bg);
+
+    if (is_revealed)
+    {
+        if (board.is_mine(i))
+        {
+            renderer_utils->batch_rounded_rect(rect, MINE_RADIUS * zoom, {0, 0, 0, 255});
+        }
+        else
+        {
+            const unsigned int mines_around = board.mines_around(i);
+            // Below a few pixels a digit is unreadable noise, the revealed background says enough
+            if (mines_around > 0 && rect.w >= MIN_NUMBER_CELL)
             {
-                for (int j = -1; j <= 1; ++j)
-                {
-                    if (i == 0 && j == 0) continue;
+                const SDL_Color draw_color = number_color(mines_around);
+
+                const char txt[2] = {static_cast<char>('0' + mines_around), 0};
 
-                    if (x + i >= 0 && x + i < cols && y + j >= 0 && y + j < rows && board[y + j][x + i].is_mine)
-                    {
-                        ++count;
-                    }
+                const int txt_padding = static_cast<int>(8.0f * zoom);
+                constexpr float GRID_NUMBER_SCALE = 0.85f;
+                const SDL_Rect bounds = {
+                    static_cast<int>(rect.x) + txt_padding,
+                    static_cast<int>(rect.y) + txt_padding,
+                    static_cast<int>(rect.w) - 2 * txt_padding,
+                    static_cast<int>(rect.h) - 2 * txt_padding
+                };
 
-                    board[y][x].mines_around = count;
-                }
+                renderer_utils->batch_txt_centered(bounds, draw_color, txt, GRID_NUMBER_SCALE);
             }
         }
     }
+
+    if (board.is_flagged(i))
+    {
+        renderer_utils->batch_ring({rect.x + rect.w / 2, rect.y + rect.h / 2, FLAG_RADIUS * zoom},
+                                   std::max(1.0f, FLAG_THICKNESS * zoom), {255, 0, 0, 255});
+    }
 }
 
-void Game::generate_grid() const
+void Game::generate_grid()
 {
-    const int rows = static_cast<int>(board.size());
-    const int cols = static_cast<int>(board[0].size());
+    // Collected every frame so the texture is current whenever it gets shown
+    minimap.note_dirty(board);
+    solver.note_dirty(board);
+    if (board.is_dirty_overflow() || !board.get_dirty().empty()) heat_stale = true;
+
+    if (use_lod() || show_minimap)
+    {
+        minimap.update(board);
+    }
 
-    for (int y = 0; y < rows; ++y)
+    // Never fall back to per cell drawing out here, the visible range can be the whole board
+    if (use_lod())
     {
-        for (int x = 0; x < cols; ++x)
+        const float pitch = camera.get_pitch();
+        const view_rect_t dst = camera.to_screen({
+            0.0f, 0.0f,
+            static_cast<float>(minimap.get_covered_cols()) * pitch,
+            static_cast<float>(minimap.get_covered_rows()) * pitch
+        });
+
+        if (minimap.is_ready())
         {
-            const auto& cell = board[y][x];
+            minimap.draw({dst.x, dst.y, dst.w, dst.h});
+            renderer_utils->add_draw_calls(1);
+        }
+        board.clear_dirty();
 
-            renderer_utils->draw_rect(cell.rect, cell.bg);
+        // The retained image stopped tracking the board, rebuild it when zooming back in
+        redraw_board = true;
+        return;
+    }
 
-            if (cell.is_revealed)
-            {
-                if (cell.is_mine)
-                {
-                    renderer_utils->draw_rounded_rect(cell.rect, 20.0f, {0, 0, 0, 255});
-                }
-                else
-                {
-                    if (cell.mines_around > 0)
-                    {
-                        const uint8_t radiant = cell.mines_around * 30;
-                        const SDL_Color draw_color = {
-                            static_cast<uint8_t>(41 + radiant),
-                            static_cast<uint8_t>(184 + radiant),
-                            static_cast<uint8_t>(255 + radiant),
-                            255
-                        };
-
-                        std::string txt = std::to_string(cell.mines_around);
-
-                        constexpr int txt_padding = 8;
-                        constexpr float GRID_NUMBER_SCALE = 0.85f;
-                        const SDL_Rect bounds = {
-                            static_cast<int>(cell.rect.x) + txt_padding,
-                            static_cast<int>(cell.rect.y) + txt_padding,
-                            static_cast<int>(cell.rect.w) - 2 * txt_padding,
-                            static_cast<int>(cell.rect.h) - 2 * txt_padding
-                        };
-
-                        renderer_utils->draw_txt_centered(bounds, draw_color, txt.c_str(), GRID_NUMBER_SCALE);
-                    }
-                }
-            }
+    const cell_range_t range = camera.visible_cells(board.get_cols(), board.get_rows());
 
-            if (cell.is_flagged)
+    if (!update_board_target())
+    {
+        // No render targets, fall back to drawing every visible cell each frame
+        for (int y = range.y0; y <= range.y1; ++y)
+        {
+            for (int x = range.x0; x <= range.x1; ++x)
             {
-                renderer_utils->draw_circle({cell.rect.x + cell.rect.w / 2, cell.rect.y + cell.rect.h / 2, 10},
-                                            {255, 0, 0, 255});
+                draw_cell(x, y);
             }
         }
+
+        renderer_utils->flush_batch();
+        board.clear_dirty();
+        return;
     }
-}
 
-bool Game::grid_mouse_action(const mouse_pos pos) const
-{
-    const int rows = static_cast<int>(board.size());
-    const int cols = static_cast<int>(board[0].size());
+    SDL_SetRenderTarget(renderer, board_target);
 
-    if (ignore_left_click_until_release)
+    if (redraw_board || board.is_dirty_overflow())
     {
-        if (!IS_PRESSED(platform::input::MOUSE_LEFT))
+        set_bg_color(platform::window::COLOR);
+        SDL_RenderClear(renderer);
+
+        for (int y = range.y0; y <= range.y1; ++y)
         {
-            ignore_left_click_until_release = false;
+            for (int x = range.x0; x <= range.x1; ++x)
+            {
+                draw_cell(x, y);
+            }
         }
-    }
 
-    for (int y = 0; y < rows; ++y)
+        redraw_board = false;
+    }
+    else
     {
-        for (int x = 0; x < cols; ++x)
+        // A redrawn cell paints its own background first, so it fully covers the old one
+        const int cols = board.get_cols();
+        for (const uint32_t i : board.get_dirty())
         {
-            const auto& cell = board[y][x];
+            const int x = static_cast<int>(i % cols);
+            const int y = static_cast<int>(i / cols);
 
-            if (check_hover(cell.rect, pos))
-            {
-                if (!ignore_left_click_until_release &&
-                    !cell.is_revealed &&
-                    !cell.is_flagged
-                    && IS_PRESSED(platform::input::MOUSE_LEFT))
-                {
-                    cell.is_revealed = true;
-                    cell.bg = platform::game::block::color::REVELED_BG;
-
-                    if (cell.is_mine)
-                    {
-                        cell.bg = platform::game::block::color::LOST_BG;
-                        return true;
-                    }
-
-                    if (!is_gen)
-                    {
-                        generate_tiles(x, y);
-                        is_gen = true;
-                    }
-
-                    loop_around_tile(x, y);
-                }
-                if (!cell.is_revealed && IS_PRESSED(platform::input::MOUSE_RIGHT))
-                {
-                    cell.is_flagged = !cell.is_flagged;
-                }
-            }
-            else
+            if (x >= range.x0 && x <= range.x1 && y >= range.y0 && y <= range.y1)
             {
+                draw_cell(x, y);
             }
         }
     }
 
-    return false;
+    // Backgrounds, mines and flags in one call, then one call per number texture
+    renderer_utils->flush_batch();
+    board.clear_dirty();
+
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_RenderCopy(renderer, board_target, nullptr, nullptr);
+    renderer_utils->add_draw_calls(1);
 }
 
-void Game::loop_around_tile(const int pos_x, const int pos_y) const
+void Game::draw_minimap()
 {
-    if (board.empty() || board[0].empty()) return;
-
-    if (!in_bounds(pos_x, pos_y)) return;
-    if (board[pos_y][pos_x].is_mine) return;
+    if (!show_minimap || !minimap.is_ready()) return;
+
+    const SDL_FRect map = minimap_rect();
+    constexpr float border = platform::game::minimap::BORDER;
+
+    renderer_utils->draw_rect({map.x - border, map.y - border, map.w + 2 * border, map.h + 2 * border},
+                              platform::game::minimap::FRAME);
+
+    // Texel blocks past the last row / column stretch a fraction of a pixel over the frame at most
+    const float cell_w = map.w / static_cast<float>(board.get_cols());
+    const float cell_h = map.h / static_cast<float>(board.get_rows());
+    minimap.draw({
+        map.x, map.y,
+        static_cast<float>(minimap.get_covered_cols()) * cell_w,
+        static_cast<float>(minimap.get_covered_rows()) * cell_h
+    });
+    renderer_utils->add_draw_calls(1);
+
+    // Camera view outline, clipped to the overlay
+    const float pitch = camera.get_pitch();
+    const float view_x0 = map.x + camera.get_x() / pitch * cell_w;
+    const float view_y0 = map.y + camera.get_y() / pitch * cell_h;
+    const float view_x1 = view_x0 + static_cast<float>(camera.get_view_w()) / camera.get_zoom() / pitch * cell_w;
+    const float view_y1 = view_y0 + static_cast<float>(camera.get_view_h()) / camera.get_zoom() / pitch * cell_h;
+
+    const SDL_FRect view = {
+        std::max(map.x, view_x0),
+        std::max(map.y, view_y0),
+        std::min(map.x + map.w, view_x1) - std::max(map.x, view_x0),
+        std::min(map.y + map.h, view_y1) - std::max(map.y, view_y0)
+    };
+
+    if (view.w > 0.0f && view.h > 0.0f)
+    {
+        constexpr SDL_Color color = platform::game::minimap::VIEW;
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderDrawRectF(renderer, &view);
+        renderer_utils->add_draw_calls(1);
+    }
+}
 
-    const bool start_is_zero = (board[pos_y][pos_x].mines_around == 0);
-    if (!start_is_zero)
+board_state::STATE Game::grid_mouse_action(const mouse_pos pos)
+{
+    if (ignore_left_click_until_release)
     {
-        return;
+        if (!IS_PRESSED(platform::input::MOUSE_LEFT))
+        {
+            ignore_left_click_until_release = false;
+        }
     }
 
-    std::queue<std::pair<int, int>> q;
+    // Clicks on the minimap steer the camera, not the board
+    const bool left_click = !ignore_left_click_until_release && !minimap_drag &&
+        IS_PRESSED(platform::input::MOUSE_LEFT);
+    const bool right_click = IS_PRESSED(platform::input::MOUSE_RIGHT);
+    if (!left_click && !right_click) return board.get_state();
 
-    if (!board[pos_y][pos_x].is_revealed)
+    int x = 0;
+    int y = 0;
+    if (!camera.cell_at(static_cast<float>(pos.x), static_cast<float>(pos.y), board.get_cols(), board.get_rows(), x, y))
     {
-        board[pos_y][pos_x].is_revealed = true;
-        board[pos_y][pos_x].bg = platform::game::block::color::REVELED_BG;
+        return board.get_state();
     }
-    q.emplace(pos_x, pos_y);
 
-    constexpr int directionCount = 8;
-    const int dx[directionCount] = {-1, 0, 1, -1, 1, -1, 0, 1};
-    const int dy[directionCount] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    // The first click waits for a no-guess layout, later clicks wait for the board
+    if (generator.is_running()) return board.get_state();
 
-    while (!q.empty())
+    if (left_click && no_guess && !board.is_generated() && !board.is_flagged(board.index(x, y)))
     {
-        auto [cx, cy] = q.front();
-        q.pop();
+        pending_x = x;
+        pending_y = y;
+        generator.start(board.get_cols(), board.get_rows(), board.get_mines(), x, y,
+                        platform::game::board::SAFE_RADIUS, board.get_seed());
+        return board.get_state();
+    }
 
-        for (int i = 0; i < directionCount; ++i)
-        {
-            int nx = cx + dx[i];
-            int ny = cy + dy[i];
-            if (!in_bounds(nx, ny)) continue;
+    if (left_click && board.start_reveal(x, y) == board_state::LOST)
+    {
+        is_lost = true;
+    }
+    if (right_click)
+    {
+        board.toggle_flag(x, y);
+    }
+
+    return board.get_state();
+}
+
+// Render
+void Game::set_bg_color(const SDL_Color color) const
+{
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+}
 
-            auto& n_cell = board[ny][nx];
-            if (n_cell.is_mine || n_cell.is_flagged || n_cell.is_revealed) continue;
+void Game::solver_action()
+{
+    if (board.get_state() != board_state::PLAYING) return;
 
-            n_cell.is_revealed = true;
-            n_cell.bg = platform::game::block::color::REVELED_BG;
+    if (IS_PRESSED(platform::input::P))
+    {
+        auto_play = !auto_play;
+    }
 
-            if (n_cell.mines_around == 0)
+    if (IS_PRESSED(platform::input::H))
+    {
+        show_hint = solver.next_safe_move(board, hint_x, hint_y);
+        if (show_hint)
+        {
+            // Brings the hint into view when it is off screen
+            const cell_range_t range = camera.visible_cells(board.get_cols(), board.get_rows());
+            if (hint_x < range.x0 || hint_x > range.x1 || hint_y < range.y0 || hint_y > range.y1)
             {
-                q.emplace(nx, ny);
+                const float pitch = camera.get_pitch();
+                camera.center_on((static_cast<float>(hint_x) + 0.5f) * pitch,
+                                 (static_cast<float>(hint_y) + 0.5f) * pitch);
             }
         }
+        else
+        {
+            SDL_Log("%s", solver.is_pending() ? "Solver still working" : "No provably safe cell, a guess is needed");
+        }
     }
-}
 
-bool Game::check_win() const
-{
-    if (board.empty() || board[0].empty()) return false;
+    if (show_hint)
+    {
+        const size_t hint = board.index(hint_x, hint_y);
+        if (board.is_revealed(hint) || board.is_flagged(hint)) show_hint = false;
+    }
 
-    const int rows = static_cast<int>(board.size());
-    const int cols = static_cast<int>(board[0].size());
+    // Waits for the cascade so each move sees the numbers it opened
+    if (!auto_play || board.is_revealing()) return;
 
-    for (int y = 0; y < rows; ++y)
+    for (int moves = 0; moves < platform::game::solver::AUTO_MOVES_PER_FRAME; ++moves)
     {
-        for (int x = 0; x < cols; ++x)
+        int x = 0;
+        int y = 0;
+        if (!solver.next_safe_move(board, x, y))
         {
-            const auto& cell = board[y][x];
-            if (!cell.is_mine && !cell.is_revealed)
+            if (!solver.is_pending())
             {
-                return false;
+                SDL_Log("Auto-play stopped, no provably safe cell left");
+                auto_play = false;
             }
+            return;
+        }
+
+        if (board.start_reveal(x, y) != board_state::PLAYING) return;
+
+        // A move that opened nothing would be offered again every frame
+        if (!board.is_revealed(board.index(x, y)))
+        {
+            SDL_Log("Auto-play stopped, (%d, %d) could not be opened", x, y);
+            auto_play = false;
+            return;
         }
     }
+}
 
-    return true;
+void Game::draw_hint()
+{
+    if (!show_hint || use_lod()) return;
+
+    const SDL_FRect rect = cell_rect(hint_x, hint_y);
+    const float t = platform::game::solver::HINT_THICKNESS;
+    constexpr SDL_Color color = platform::game::solver::HINT;
+
+    renderer_utils->draw_rect({rect.x, rect.y, rect.w, t}, color);
+    renderer_utils->draw_rect({rect.x, rect.y + rect.h - t, rect.w, t}, color);
+    renderer_utils->draw_rect({rect.x, rect.y, t, rect.h}, color);
+    renderer_utils->draw_rect({rect.x + rect.w - t, rect.y, t, rect.h}, color);
 }
 
-bool Game::in_bounds(const int x, const int y) const
+void Game::update_probabilities()
 {
-    const int rows = static_cast<int>(board.size());
-    const int cols = static_cast<int>(board[0].size());
+    if (IS_PRESSED(platform::input::I))
+    {
+        show_heat = !show_heat;
+    }
+
+    if (!show_heat || use_lod() || !board.is_generated() || board.get_state() != board_state::PLAYING) return;
+
+    // Numbers still arriving would only be thrown away next frame
+    if (board.is_revealing() || solver.is_pending()) return;
 
-    return x >= 0 && x < cols && y >= 0 && y < rows;
+    // Past a full scan the engine only looks around the view, so panning needs a new pass too
+    const cell_range_t range = camera.visible_cells(board.get_cols(), board.get_rows());
+    const bool moved = !probability.is_exact() &&
+        (range.x0 != heat_range.x0 || range.y0 != heat_range.y0 ||
+         range.x1 != heat_range.x1 || range.y1 != heat_range.y1);
+    if (!heat_stale && !moved) return;
+
+    // A ring of one cell, so numbers just outside the view still constrain the border cells
+    probability.compute(board, solver, range.x0 - 1, range.y0 - 1, range.x1 + 1, range.y1 + 1);
+    heat_range = range;
+    heat_stale = false;
 }
 
-// Render
-void Game::set_bg_color(const SDL_Color color) const
+void Game::draw_heat_map()
 {
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    if (!show_heat || use_lod() || !board.is_generated()) return;
+
+    const cell_range_t range = camera.visible_cells(board.get_cols(), board.get_rows());
+    for (int y = range.y0; y <= range.y1; ++y)
+    {
+        for (int x = range.x0; x <= range.x1; ++x)
+        {
+            const float p = probability.probability(board, solver, board.index(x, y));
+            if (p < 0.0f) continue;
+
+            renderer_utils->batch_heat(cell_rect(x, y), p, platform::game::solver::HEAT_ALPHA);
+        }
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    renderer_utils->flush_batch();
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+void Game::update_generator()
+{
+    if (generator.step()) return;
+
+    const no_guess_stats_t& stats = generator.get_stats();
+    uint64_t seed = 0;
+    if (generator.get_result(seed))
+    {
+        board.set_seed(seed);
+        SDL_Log("No-guess board after %llu tries in %.2f ms (p50 %.2f, p95 %.2f, p99 %.2f ms)",
+                static_cast<unsigned long long>(stats.tries), stats.last_ms, stats.p50_ms, stats.p95_ms,
+                stats.p99_ms);
+    }
+    else
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "No no-guess board within %llu tries, dealing a regular one",
+                    static_cast<unsigned long long>(stats.tries));
+    }
+
+    if (board.start_reveal(pending_x, pending_y) == board_state::LOST)
+    {
+        is_lost = true;
+    }
 }
@@ -12,40 +12,94 @@
 #include <score_manager.h>
 #include <platform.h>
 #include <renderer.h>
+#include <board.h>
+#include <camera.h>
+#include <minimap.h>
+#include <resource_cache.h>
+#include <profiler.h>
+#include <solver.h>
+#include <probability.h>
+#include <thread_pool.h>
+#include <no_guess.h>
 
 #define IS_DOWN(button) input.buttons[button].is_down
 #define IS_PRESSED(button) (input.buttons[button].is_down && input.buttons[button].changed)
 #define IS_RELEASED(button) (!input.buttons[button].is_down && input.buttons[button].changed)
 
-typedef struct BLOCK_STATS {
-    SDL_FRect rect;
-    mutable SDL_Color bg;
-    unsigned int mines_around{0};
-    bool is_mine{false};
-    mutable bool is_flagged{false};
-    mutable bool is_revealed{false};
-} block_stats_t;
-
 class Game {
     SDL_Renderer *renderer;
     TTF_Font *font;
+    ResourceCache *resources;
     ScoreManager *score_manager;
     platform::input::input_t input;
     Renderer *renderer_utils;
+    Board board;
+    uint32_t reveal_budget_us{platform::game::board::REVEAL_BUDGET_US};
+
+    // Retained board image, only cells the board reports dirty are redrawn into it
+    SDL_Texture *board_target{nullptr};
+    int board_target_w{0};
+    int board_target_h{0};
+    bool redraw_board{true};
+
+    // Pan / zoom over the grid, board_target holds what it saw on the last redraw
+    Camera camera{platform::game::block::SIZE, platform::game::block::OFFSET};
+    float drawn_x{0.0f};
+    float drawn_y{0.0f};
+    float drawn_zoom{0.0f};
+    double last_frame_time{0.0};
+
+    // Overview texture, toggled as an overlay with M and used as the view when zoomed far out
+    Minimap minimap;
+    bool show_minimap{false};
+    bool minimap_drag{false};
+
+    // Deductions from the revealed numbers, H shows the next safe cell and P plays them
+    Solver solver;
+    bool show_hint{false};
+    int hint_x{0};
+    int hint_y{0};
+    bool auto_play{false};
+
+    // Mine probabilities over the closed cells, toggled with I and recomputed after the board changes
+    ThreadPool pool;
+    ProbabilityEngine probability{&pool};
+    bool show_heat{false};
+    bool heat_stale{true};
+    cell_range_t heat_range{0, 0, -1, -1};
+
+    // No-guess mode searches layouts after the first click, which is replayed once one is found
+    NoGuessGenerator generator{&pool};
+    bool no_guess{false};
+    int pending_x{0};
+    int pending_y{0};
+
+    // Frame timing overlay, toggled with F3
+    bool show_profiler{false};
+
+    // Last title handed to SDL
+    mutable char window_title[96]{};
 
     typedef struct MOUSE_POS {
         int x;
         int y;
     } mouse_pos;
 
+    mouse_pos drag_pos{0, 0};
+
 public:
-    Game(SDL_Renderer *_renderer, const platform::input::input_t _input, TTF_Font *_font)
-        : renderer{_renderer}, font{_font}, input{_input} {
+    Game(SDL_Renderer *_renderer, const platform::input::input_t _input, TTF_Font *_font,
+         ResourceCache *_resources)
+        : renderer{_renderer}, font{_font}, resources{_resources}, input{_input}, minimap{_renderer} {
         score_manager = new ScoreManager{platform::file::NAME};
         renderer_utils = new Renderer{renderer, font};
+        warm_render_caches();
+        board.set_track_dirty(true);
+        camera.set_zoom_limits(platform::game::camera::MIN_ZOOM, platform::game::camera::MAX_ZOOM);
+        probability.set_work_cap(platform::game::solver::PROBABILITY_WORK_CAP);
     };
 
-    ~Game() = default;
+    ~Game();
 
 public
 :
@@ -55,32 +109,81 @@ public
                                                               double elapsed_time,
                                                               platform::game::board::board_settings_t board_size);
 
+    // Board with a dimmed "Paused" overlay, the clock is held by the caller
+    void pause_screen(SDL_Window *window);
+
+    // Stage percentiles, allocations, frame time graph and draw statistics, drawn last in the frame
+    void draw_profiler_overlay();
+
+    // How long the loop may sleep before the game needs another frame, 0 while anything animates
+    [[nodiscard]] uint32_t idle_timeout_ms(double elapsed_time) const;
+
     void update_input(const platform::input::input_t _input) {
         input = _input;
     }
 
     void set_bg_color(SDL_Color color) const;
 
+    void set_reveal_budget(uint32_t _reveal_budget_us) {
+        reveal_budget_us = _reveal_budget_us;
+    }
+
+    // Forces a full board redraw, e.g. after the renderer lost its render targets
+    void invalidate_board() {
+        redraw_board = true;
+        minimap.invalidate();
+    }
+
 private:
+    // Rasterises the grid numbers, menu labels and sprite shapes up front
+    void warm_render_caches() const;
+
     bool check_hover(SDL_FRect rect, const mouse_pos pos) const;
 
     void set_cursor(bool is_hovering) const;
 
-    void get_time_stamp(double elapsed_time, char *time_stamp) const;
+    void get_time_stamp(double elapsed_time, char *time_stamp, size_t size) const;
+
+    // SDL_SetWindowTitle copies the string every call, so only pass on changes
+    void set_title(SDL_Window *window, const char *title) const;
+
+    void board_init(platform::game::board::board_settings_t board_size);
+
+    // Pans with WASD / arrows / middle drag, zooms around the cursor with the wheel
+    void update_camera(mouse_pos pos, double elapsed_time);
+
+    [[nodiscard]] SDL_FRect cell_rect(int x, int y) const;
+
+    // Screen area of the minimap overlay, bottom right
+    [[nodiscard]] SDL_FRect minimap_rect() const;
+
+    // True while cells are too small to draw one by one
+    [[nodiscard]] bool use_lod() const;
+
+    // Makes sure board_target matches the output size, false if render targets are unavailable
+    bool update_board_target();
+
+    void draw_cell(int x, int y) const;
+
+    void generate_grid();
 
-    void board_init(platform::game::board::board_settings_t board_size) const;
+    void draw_minimap();
 
-    void generate_tiles(int safe_x, int safe_y) const;
+    board_state::STATE grid_mouse_action(const mouse_pos pos);
 
-    void generate_grid() const;
+    // Hint and auto-play keys, opens cells the solver proved safe
+    void solver_action();
 
-    bool grid_mouse_action(const mouse_pos pos) const;
+    // Outline around the hinted cell, drawn over the board
+    void draw_hint();
 
-    void loop_around_tile(const int pos_x, const int pos_y) const;
+    // Recomputes the probabilities once the board and the solver settled after a change
+    void update_probabilities();
 
-    bool check_win() const;
+    void draw_heat_map();
 
-    bool in_bounds(const int x, const int y) const;
+    // Checks a batch of no-guess candidates, then plays the held first click on the winner
+    void update_generator();
 };
 
 #endif //GAME_H
@@ -0,0 +1,208 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "no_guess.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "board.h"
+#include "solver.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+void NoGuessGenerator::start(const int _cols, const int _rows, const int _mines, const int _safe_x,
+                             const int _safe_y, const int _safe_radius, const uint64_t _base_seed)
+{
+    cols = _cols;
+    rows = _rows;
+    mines = _mines;
+    safe_x = _safe_x;
+    safe_y = _safe_y;
+    safe_radius = _safe_radius;
+    base_seed = _base_seed;
+
+    next_index = 0;
+    running = true;
+    found = false;
+    result_seed = 0;
+    start_time = std::chrono::steady_clock::now();
+    stats.tries = 0;
+    cancelled.store(false, std::memory_order_relaxed);
+}
+
+bool NoGuessGenerator::step()
+{
+    if (!running) return false;
+
+    if (cancelled.load(std::memory_order_relaxed))
+    {
+        running = false;
+        return false;
+    }
+
+    TRACE_ZONE("no_guess_batch");
+
+    const size_t batch = std::min(MAX_BATCH, PER_THREAD * (pool ? pool->get_thread_count() : 1));
+    const uint64_t first = next_index;
+    const auto check = [this, first](const size_t k) {
+        solvable[k] = is_solvable(cols, rows, mines, safe_x, safe_y, safe_radius,
+                                  candidate_seed(base_seed, first + k), &cancelled) ? 1 : 0;
+    };
+
+    if (pool)
+    {
+        pool->parallel_for(batch, check);
+    }
+    else
+    {
+        for (size_t k = 0; k < batch; ++k) check(k);
+    }
+
+    if (cancelled.load(std::memory_order_relaxed))
+    {
+        running = false;
+        return false;
+    }
+
+    next_index += batch;
+
+    // Every earlier batch failed, so the first hit here is the smallest solvable index overall
+    for (size_t k = 0; k < batch; ++k)
+    {
+        if (!solvable[k]) continue;
+
+        stats.tries += k + 1;
+        stats.total_tries += k + 1;
+        result_seed = candidate_seed(base_seed, first + k);
+        finish(true);
+        return false;
+    }
+
+    stats.tries += batch;
+    stats.total_tries += batch;
+
+    if (next_index >= max_tries)
+    {
+        finish(false);
+        return false;
+    }
+
+    return true;
+}
+
+bool NoGuessGenerator::run()
+{
+    while (step())
+    {
+    }
+
+    return found;
+}
+
+void NoGuessGenerator::cancel()
+{
+    cancelled.store(true, std::memory_order_relaxed);
+}
+
+void NoGuessGenerator::set_max_tries(const uint64_t _max_tries)
+{
+    max_tries = std::max<uint64_t>(_max_tries, 1);
+}
+
+bool NoGuessGenerator::is_running() const
+{
+    return running;
+}
+
+bool NoGuessGenerator::get_result(uint64_t& seed) const
+{
+    if (!found) return false;
+
+    seed = result_seed;
+    return true;
+}
+
+const no_guess_stats_t& NoGuessGenerator::get_stats() const
+{
+    return stats;
+}
+
+uint64_t NoGuessGenerator::candidate_seed(const uint64_t base, const uint64_t index)
+{
+    // splitmix64 over the pair, neighbouring indices land on unrelated seeds
+    uint64_t z = base + (index + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+bool NoGuessGenerator::is_solvable(const int cols, const int rows, const int mines, const int safe_x,
+                                   const int safe_y, const int safe_radius, const uint64_t seed,
+                                   const std::atomic<bool>* cancel)
+{
+    // Pool threads live as long as the pool, their planes keep their capacity between candidates
+    thread_local Board board;
+    thread_local Solver solver;
+
+    board.init(cols, rows, mines);
+    board.set_seed(seed);
+    board.set_safe_radius(safe_radius);
+    board.set_track_dirty(true);
+    board.clear_dirty();
+    solver.reset(cols, rows);
+
+    board.reveal(safe_x, safe_y);
+
+    while (board.get_state() == board_state::PLAYING)
+    {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+
+        solver.note_dirty(board);
+        board.clear_dirty();
+        solver.drain(board);
+
+        int x = 0;
+        int y = 0;
+        if (!solver.next_safe_move(board, x, y)) return false;
+
+        board.reveal(x, y);
+    }
+
+    return board.get_state() == board_state::WON;
+}
+
+void NoGuessGenerator::finish(const bool success)
+{
+    running = false;
+    found = success;
+
+    if (success)
+    {
+        ++stats.boards;
+    }
+    else
+    {
+        ++stats.failures;
+    }
+
+    stats.last_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+    latencies[latency_head] = stats.last_ms;
+    latency_head = (latency_head + 1) % HISTORY;
+    latency_count = std::min(latency_count + 1, HISTORY);
+
+    // Nearest rank over a copy, the history is small
+    double sorted[HISTORY];
+    std::copy(latencies, latencies + latency_count, sorted);
+    std::sort(sorted, sorted + latency_count);
+
+    const auto rank = [&sorted, this](const double p) {
+        const int k = static_cast<int>(std::ceil(p * latency_count)) - 1;
+        return sorted[std::clamp(k, 0, latency_count - 1)];
+    };
+    stats.p50_ms = rank(0.50);
+    stats.p95_ms = rank(0.95);
+    stats.p99_ms = rank(0.99);
+}
@@ -0,0 +1,113 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef NO_GUESS_H
+#define NO_GUESS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+// Searches for a board the deduction solver finishes from the first click
+// without ever guessing. Candidate i is the board of seed candidate_seed(base, i),
+// candidates are checked a batch at a time across the pool in index order and
+// the smallest solvable index wins, so the result only depends on the base
+// seed, never on the thread count or the batch size.
+
+typedef struct NO_GUESS_STATS
+{
+    // Candidates checked by the current or last search
+    uint64_t tries;
+    // Over every search since construction
+    uint64_t total_tries;
+    uint64_t boards;
+    uint64_t failures;
+    // Start to result of the last search, and percentiles over the recent ones
+    double last_ms;
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+} no_guess_stats_t;
+
+class NoGuessGenerator
+{
+    // Candidates per thread and step, and the most a step checks at all
+    static constexpr size_t PER_THREAD{4};
+    static constexpr size_t MAX_BATCH{64};
+    static constexpr uint64_t DEFAULT_MAX_TRIES{20000};
+    // Searches kept for the latency percentiles
+    static constexpr int HISTORY{128};
+
+    ThreadPool* pool;
+
+    int cols{0};
+    int rows{0};
+    int mines{0};
+    int safe_x{0};
+    int safe_y{0};
+    int safe_radius{1};
+    uint64_t base_seed{0};
+
+    uint64_t next_index{0};
+    uint64_t max_tries{DEFAULT_MAX_TRIES};
+    bool running{false};
+    bool found{false};
+    uint64_t result_seed{0};
+    std::chrono::steady_clock::time_point start_time{};
+
+    // Set from any thread, candidates in flight stop at their next solver step
+    std::atomic<bool> cancelled{false};
+
+    // Solvable flags of the batch in flight
+    uint8_t solvable[MAX_BATCH]{};
+
+    no_guess_stats_t stats{};
+    double latencies[HISTORY]{};
+    int latency_head{0};
+    int latency_count{0};
+
+public:
+    explicit NoGuessGenerator(ThreadPool* _pool) : pool{_pool}
+    {
+    };
+
+    ~NoGuessGenerator() = default;
+
+public:
+    // Begins a search for a board whose first click is (x, y), dropping any search in flight
+    void start(int _cols, int _rows, int _mines, int _safe_x, int _safe_y, int _safe_radius, uint64_t _base_seed);
+
+    // Checks one batch of candidates. Returns true while the search goes on.
+    bool step(void);
+
+    // Steps until the search ends, true when a board was found
+    bool run(void);
+
+    // Safe to call from any thread, the search ends without a result
+    void cancel(void);
+
+    void set_max_tries(uint64_t _max_tries);
+
+    [[nodiscard]] bool is_running(void) const;
+
+    // Seed of the board found by the last search, false if it failed or was cancelled
+    bool get_result(uint64_t& seed) const;
+
+    [[nodiscard]] const no_guess_stats_t& get_stats(void) const;
+
+    [[nodiscard]] static uint64_t candidate_seed(uint64_t base, uint64_t index);
+
+    // Plays the board with the deduction solver only, true when it wins.
+    // Reuses per thread scratch boards, so steady use does not allocate.
+    [[nodiscard]] static bool is_solvable(int cols, int rows, int mines, int safe_x, int safe_y, int safe_radius,
+                                          uint64_t seed, const std::atomic<bool>* cancel);
+
+private:
+    void finish(bool success);
+};
+
+#endif //NO_GUESS_H
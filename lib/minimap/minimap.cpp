@@ -0,0 +1,305 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "minimap.h"
+
+#include <algorithm>
+
+#include <platform.h>
+
+static uint32_t pack_argb(const float r, const float g, const float b)
+{
+    return 0xFF000000u |
+        (static_cast<uint32_t>(r) << 16) |
+        (static_cast<uint32_t>(g) << 8) |
+        static_cast<uint32_t>(b);
+}
+
+static float lerp(const float a, const float b, const float t)
+{
+    return a + (b - a) * t;
+}
+
+// Same colours per cell drawing uses, so switching views does not change the picture
+static constexpr SDL_Color FLAG_COLOR{255, 0, 0, 255};
+
+Minimap::~Minimap()
+{
+    if (texture)
+    {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void Minimap::resize(const int _cols, const int _rows)
+{
+    cols = std::max(0, _cols);
+    rows = std::max(0, _rows);
+
+    SDL_RendererInfo info{};
+    SDL_GetRendererInfo(renderer, &info);
+
+    // 0 means the renderer does not report a limit
+    const int max_w = info.max_texture_width > 0 ? info.max_texture_width : 16384;
+    const int max_h = info.max_texture_height > 0 ? info.max_texture_height : 16384;
+
+    block = 1;
+    while (true)
+    {
+        tex_w = (cols + block - 1) / block;
+        tex_h = (rows + block - 1) / block;
+
+        const size_t bytes = static_cast<size_t>(tex_w) * static_cast<size_t>(tex_h) * sizeof(uint32_t);
+        if (tex_w <= max_w && tex_h <= max_h && bytes <= MAX_BYTES) break;
+
+        ++block;
+    }
+
+    invalidate();
+}
+
+void Minimap::invalidate()
+{
+    if (texture)
+    {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+
+    row_dirty.assign(static_cast<size_t>(tex_h), 0);
+    open_counts.assign(static_cast<size_t>(tex_w), 0);
+    flag_counts.assign(static_cast<size_t>(tex_w), 0);
+    mark_rows(0, tex_h - 1);
+}
+
+void Minimap::note_dirty(const Board& board)
+{
+    if (tex_h <= 0) return;
+
+    const size_t row_cells = static_cast<size_t>(cols) * static_cast<size_t>(block);
+
+    if (board.is_dirty_overflow())
+    {
+        size_t lo = 0;
+        size_t hi = 0;
+        if (board.get_dirty_range(lo, hi))
+        {
+            mark_rows(static_cast<int>(lo / row_cells), static_cast<int>(hi / row_cells));
+        }
+        return;
+    }
+
+    for (const uint32_t i : board.get_dirty())
+    {
+        const int ty = static_cast<int>(i / row_cells);
+        mark_rows(ty, ty);
+    }
+}
+
+bool Minimap::update(const Board& board)
+{
+    if (tex_w <= 0 || tex_h <= 0) return false;
+
+    if (!texture)
+    {
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, tex_w, tex_h);
+        if (!texture)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to create %dx%d minimap texture: %s", tex_w, tex_h,
+                         SDL_GetError());
+            // Gives up until the next resize instead of retrying every frame
+            tex_w = 0;
+            tex_h = 0;
+            return false;
+        }
+
+        // Hard texel edges, a blurred board reads as noise
+        SDL_SetTextureScaleMode(texture, SDL_ScaleModeNearest);
+
+        // Start from an all hidden board so the texture is drawable while stale rows catch up
+        void* pixels = nullptr;
+        int pitch = 0;
+        if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) == 0)
+        {
+            constexpr SDL_Color hidden = platform::game::block::color::BG;
+            const uint32_t hidden_px = pack_argb(hidden.r, hidden.g, hidden.b);
+
+            for (int row = 0; row < tex_h; ++row)
+            {
+                uint32_t* dst = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pixels) +
+                    static_cast<size_t>(row) * pitch);
+                std::fill(dst, dst + tex_w, hidden_px);
+            }
+
+            SDL_UnlockTexture(texture);
+        }
+
+        std::fill(row_dirty.begin(), row_dirty.end(), 1);
+        pending_lo = 0;
+        pending_hi = tex_h - 1;
+    }
+
+    const size_t cells_per_row = static_cast<size_t>(tex_w) * static_cast<size_t>(block) * block;
+    size_t budget = CELLS_PER_UPDATE;
+
+    int ty = pending_lo;
+    while (ty <= pending_hi && budget > 0)
+    {
+        if (!row_dirty[ty])
+        {
+            ++ty;
+            continue;
+        }
+
+        // Lock the whole run of stale rows at once, capped by the budget
+        int run_end = ty;
+        size_t run_cells = cells_per_row;
+        while (run_end + 1 <= pending_hi && row_dirty[run_end + 1] && run_cells + cells_per_row <= budget)
+        {
+            ++run_end;
+            run_cells += cells_per_row;
+        }
+
+        const SDL_Rect rect = {0, ty, tex_w, run_end - ty + 1};
+        void* pixels = nullptr;
+        int pitch = 0;
+        if (SDL_LockTexture(texture, &rect, &pixels, &pitch) != 0)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to lock minimap texture: %s", SDL_GetError());
+            break;
+        }
+
+        for (int row = ty; row <= run_end; ++row)
+        {
+            fill_row(board, row, reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pixels) +
+                static_cast<size_t>(row - ty) * pitch));
+            row_dirty[row] = 0;
+        }
+
+        SDL_UnlockTexture(texture);
+
+        budget = run_cells >= budget ? 0 : budget - run_cells;
+        ty = run_end + 1;
+    }
+
+    pending_lo = ty;
+    if (pending_lo > pending_hi)
+    {
+        pending_lo = 0;
+        pending_hi = -1;
+    }
+
+    return true;
+}
+
+void Minimap::draw(const SDL_FRect dst) const
+{
+    if (!texture) return;
+
+    SDL_RenderCopyF(renderer, texture, nullptr, &dst);
+}
+
+bool Minimap::is_ready() const
+{
+    return texture != nullptr;
+}
+
+bool Minimap::is_complete() const
+{
+    return texture && pending_lo > pending_hi;
+}
+
+int Minimap::get_block() const
+{
+    return block;
+}
+
+int Minimap::get_covered_cols() const
+{
+    return tex_w * block;
+}
+
+int Minimap::get_covered_rows() const
+{
+    return tex_h * block;
+}
+
+void Minimap::mark_rows(int texel_lo, int texel_hi)
+{
+    texel_lo = std::max(0, texel_lo);
+    texel_hi = std::min(tex_h - 1, texel_hi);
+    if (texel_lo > texel_hi) return;
+
+    std::fill(row_dirty.begin() + texel_lo, row_dirty.begin() + texel_hi + 1, 1);
+
+    if (pending_lo > pending_hi)
+    {
+        pending_lo = texel_lo;
+        pending_hi = texel_hi;
+    }
+    else
+    {
+        pending_lo = std::min(pending_lo, texel_lo);
+        pending_hi = std::max(pending_hi, texel_hi);
+    }
+}
+
+void Minimap::fill_row(const Board& board, const int ty, uint32_t* pixels)
+{
+    constexpr SDL_Color hidden = platform::game::block::color::BG;
+    constexpr SDL_Color revealed = platform::game::block::color::REVELED_BG;
+
+    const int y0 = ty * block;
+    const int y1 = std::min(rows, y0 + block);
+
+    if (block == 1)
+    {
+        const uint32_t hidden_px = pack_argb(hidden.r, hidden.g, hidden.b);
+        const uint32_t revealed_px = pack_argb(revealed.r, revealed.g, revealed.b);
+        const uint32_t flag_px = pack_argb(lerp(hidden.r, FLAG_COLOR.r, 0.5f),
+                                           lerp(hidden.g, FLAG_COLOR.g, 0.5f),
+                                           lerp(hidden.b, FLAG_COLOR.b, 0.5f));
+
+        for (int x = 0; x < cols; ++x)
+        {
+            const size_t i = board.index(x, y0);
+            pixels[x] = board.is_revealed(i) ? revealed_px : board.is_flagged(i) ? flag_px : hidden_px;
+        }
+        return;
+    }
+
+    std::fill(open_counts.begin(), open_counts.end(), 0);
+    std::fill(flag_counts.begin(), flag_counts.end(), 0);
+    for (int y = y0; y < y1; ++y)
+    {
+        board.accumulate_row(y, block, open_counts.data(), flag_counts.data());
+    }
+
+    // Blend by the share of revealed cells, any flag pulls the texel towards red
+    for (int tx = 0; tx < tex_w; ++tx)
+    {
+        const int x0 = tx * block;
+        const int x1 = std::min(cols, x0 + block);
+
+        const uint32_t open = open_counts[tx];
+        const uint32_t flags = flag_counts[tx];
+
+        const float total = static_cast<float>((x1 - x0) * (y1 - y0));
+        const float t = static_cast<float>(open) / total;
+
+        float r = lerp(hidden.r, revealed.r, t);
+        float g = lerp(hidden.g, revealed.g, t);
+        float b = lerp(hidden.b, revealed.b, t);
+
+        if (flags > 0)
+        {
+            const float f = std::max(0.5f, static_cast<float>(flags) / total);
+            r = lerp(r, FLAG_COLOR.r, f);
+            g = lerp(g, FLAG_COLOR.g, f);
+            b = lerp(b, FLAG_COLOR.b, f);
+        }
+
+        pixels[tx] = pack_argb(r, g, b);
+    }
+}
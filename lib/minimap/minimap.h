@@ -0,0 +1,88 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <board.h>
+
+// Board state as a streaming texture, one texel per cell or per block x block
+// cells on boards too large for one. Serves as the minimap overlay and as the
+// main view once cells shrink below a few pixels.
+class Minimap
+{
+    SDL_Renderer* renderer;
+    SDL_Texture* texture{nullptr};
+
+    int cols{0};
+    int rows{0};
+
+    // Cells per texel side
+    int block{1};
+    int tex_w{0};
+    int tex_h{0};
+
+    // Texel rows that no longer match the board, [pending_lo, pending_hi] bounds the set ones
+    std::vector<uint8_t> row_dirty;
+    int pending_lo{0};
+    int pending_hi{-1};
+
+    // Per texel scratch counts for one texel row
+    std::vector<uint32_t> open_counts;
+    std::vector<uint32_t> flag_counts;
+
+    // Upper bound for the texture, a 10000x10000 board ends up at 3x3 cells per texel
+    static constexpr size_t MAX_BYTES{64u << 20};
+    // Cells summarised per update, a full rebuild of a huge board spreads over a few frames
+    static constexpr size_t CELLS_PER_UPDATE{1u << 22};
+
+public:
+    explicit Minimap(SDL_Renderer* _renderer) : renderer{_renderer}
+    {
+    };
+
+    ~Minimap();
+
+public:
+    // Picks the block size for a new board and marks every texel row stale
+    void resize(int _cols, int _rows);
+
+    // Drops the texture, e.g. after a render device reset
+    void invalidate(void);
+
+    // Marks the texel rows touched by the board's dirty cells, call before Board::clear_dirty
+    void note_dirty(const Board& board);
+
+    // Uploads stale rows within the per update budget, false when there is nothing to draw
+    bool update(const Board& board);
+
+    void draw(SDL_FRect dst) const;
+
+public:
+    // Has a texture to draw, rows may still be catching up
+    [[nodiscard]] bool is_ready(void) const;
+
+    // Every texel matches the board
+    [[nodiscard]] bool is_complete(void) const;
+
+    [[nodiscard]] int get_block(void) const;
+
+    // Cells spanned by the texture, rounded up to whole blocks
+    [[nodiscard]] int get_covered_cols(void) const;
+
+    [[nodiscard]] int get_covered_rows(void) const;
+
+private:
+    void mark_rows(int texel_lo, int texel_hi);
+
+    // Writes texel row ty into a locked row of the texture
+    void fill_row(const Board& board, int ty, uint32_t* pixels);
+};
+
+#endif //MINIMAP_H
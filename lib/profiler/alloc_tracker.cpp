@@ -0,0 +1,179 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "alloc_tracker.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace alloc_tracker
+{
+    // Plain thread_local integers, no atomics on the allocation path
+    static thread_local uint64_t count{0};
+    static thread_local uint64_t bytes{0};
+
+    bool is_available()
+    {
+#if defined(MINESWEEPER_ALLOC_TRACKING) && MINESWEEPER_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint64_t get_count()
+    {
+        return count;
+    }
+
+    uint64_t get_bytes()
+    {
+        return bytes;
+    }
+}
+
+#if defined(MINESWEEPER_ALLOC_TRACKING) && MINESWEEPER_ALLOC_TRACKING
+
+static void* tracked_alloc(const std::size_t size)
+{
+    ++alloc_tracker::count;
+    alloc_tracker::bytes += size;
+
+    return std::malloc(size > 0 ? size : 1);
+}
+
+// Aligned blocks need their own free on Windows, the aligned deletes below are their only way back
+static void* tracked_aligned_alloc(const std::size_t size, const std::align_val_t alignment)
+{
+    ++alloc_tracker::count;
+    alloc_tracker::bytes += size;
+
+    const auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size > 0 ? size : 1, align);
+#else
+    // aligned_alloc wants the size to be a multiple of the alignment
+    const std::size_t rounded = size > 0 ? (size + align - 1) / align * align : align;
+    return std::aligned_alloc(align, rounded);
+#endif
+}
+
+static void aligned_free(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(const std::size_t size)
+{
+    if (void* p = tracked_alloc(size)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const std::size_t size)
+{
+    if (void* p = tracked_alloc(size)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tracked_alloc(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tracked_alloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    if (void* p = tracked_aligned_alloc(size, alignment)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+    if (void* p = tracked_aligned_alloc(size, alignment)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return tracked_aligned_alloc(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return tracked_aligned_alloc(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    aligned_free(p);
+}
+
+#endif
@@ -0,0 +1,27 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstdint>
+
+// Counts heap allocations made through operator new, the aligned overloads
+// included. Counters are per thread, so a stage measured on the main thread is
+// not polluted by worker pools. Allocations made with malloc, by SDL for
+// example, are not seen. Without MINESWEEPER_ALLOC_TRACKING (off by default)
+// operator new is left alone and every counter stays 0.
+
+namespace alloc_tracker
+{
+    [[nodiscard]] bool is_available(void);
+
+    // Allocations made by the calling thread so far
+    [[nodiscard]] uint64_t get_count(void);
+
+    // Bytes requested by the calling thread so far
+    [[nodiscard]] uint64_t get_bytes(void);
+}
+
+#endif //ALLOC_TRACKER_H
@@ -0,0 +1,116 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+Profiler::Profiler()
+{
+    series_id("frame");
+}
+
+Profiler& Profiler::get()
+{
+    static Profiler instance;
+    return instance;
+}
+
+int Profiler::series_id(const char* name)
+{
+    for (size_t i = 0; i < series.size(); ++i)
+    {
+        if (std::strcmp(series[i].name, name) == 0) return static_cast<int>(i);
+    }
+
+    series_t added{};
+    added.name = name;
+    series.push_back(added);
+
+    return static_cast<int>(series.size() - 1);
+}
+
+void Profiler::begin_frame()
+{
+    frame_start = now();
+}
+
+void Profiler::end_frame()
+{
+    add(FRAME, std::chrono::duration<double, std::milli>(now() - frame_start).count());
+
+    for (auto& s : series)
+    {
+        // Series that did not run this frame keep their history as is
+        if (!s.touched)
+        {
+            s.allocs = 0;
+            continue;
+        }
+
+        const int slot = (s.head + s.count) % HISTORY;
+        s.samples[slot] = static_cast<float>(s.pending_ms);
+        if (s.count < HISTORY)
+        {
+            ++s.count;
+        }
+        else
+        {
+            s.head = (s.head + 1) % HISTORY;
+        }
+
+        s.allocs = s.pending_allocs;
+
+        s.pending_ms = 0.0;
+        s.pending_allocs = 0;
+        s.touched = false;
+    }
+}
+
+void Profiler::add(const int id, const double ms)
+{
+    if (id < 0 || static_cast<size_t>(id) >= series.size()) return;
+
+    series[id].pending_ms += ms;
+    series[id].touched = true;
+}
+
+void Profiler::add_allocs(const int id, const uint64_t count)
+{
+    if (id < 0 || static_cast<size_t>(id) >= series.size()) return;
+
+    series[id].pending_allocs += count;
+    series[id].touched = true;
+}
+
+float Profiler::percentile(const int id, const float p) const
+{
+    if (id < 0 || static_cast<size_t>(id) >= series.size()) return 0.0f;
+
+    const series_t& s = series[id];
+    if (s.count == 0) return 0.0f;
+
+    scratch.assign(s.samples, s.samples + s.count);
+
+    const auto rank = static_cast<size_t>(std::clamp(p, 0.0f, 1.0f) * static_cast<float>(s.count - 1) + 0.5f);
+    std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+
+    return scratch[rank];
+}
+
+float Profiler::latest(const int id) const
+{
+    if (id < 0 || static_cast<size_t>(id) >= series.size()) return 0.0f;
+
+    const series_t& s = series[id];
+    if (s.count == 0) return 0.0f;
+
+    return s.samples[(s.head + s.count - 1) % HISTORY];
+}
+
+const std::vector<Profiler::series_t>& Profiler::get_series() const
+{
+    return series;
+}
@@ -0,0 +1,107 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Per frame timings of named series (loop stages and engine sub-steps) kept
+// in fixed rings, so percentiles cover the last HISTORY frames. SDL-free,
+// a series is registered on first use and addressed by its index after that.
+class Profiler
+{
+public:
+    static constexpr int HISTORY{240};
+
+    typedef struct SERIES
+    {
+        const char* name;
+        // Milliseconds per frame the series ran in, oldest at head once full
+        float samples[HISTORY];
+        int head;
+        int count;
+        // Time collected during the current frame, a series may run several times per frame
+        double pending_ms;
+        bool touched;
+        // Heap allocations during the last frame, see alloc_tracker
+        uint64_t allocs;
+        uint64_t pending_allocs;
+    } series_t;
+
+    // Series 0, time from begin_frame to end_frame
+    static constexpr int FRAME{0};
+
+private:
+    std::vector<series_t> series;
+    mutable std::vector<float> scratch;
+
+    std::chrono::steady_clock::time_point frame_start{};
+
+public:
+    Profiler();
+
+    ~Profiler() = default;
+
+    // Process wide instance, stages and engine code report into the same frame
+    static Profiler& get(void);
+
+public:
+    // Index of the named series, registered on first use. Names must outlive the profiler.
+    int series_id(const char* name);
+
+    void begin_frame(void);
+
+    // Moves this frame's timings into the rings
+    void end_frame(void);
+
+    void add(int id, double ms);
+
+    void add_allocs(int id, uint64_t count);
+
+    // p in [0, 1] over the recorded frames, 0 without samples
+    [[nodiscard]] float percentile(int id, float p) const;
+
+    [[nodiscard]] float latest(int id) const;
+
+    [[nodiscard]] const std::vector<series_t>& get_series(void) const;
+
+    [[nodiscard]] static std::chrono::steady_clock::time_point now(void)
+    {
+        return std::chrono::steady_clock::now();
+    }
+};
+
+// Adds the time until the end of the enclosing scope to a series
+class ProfileScope
+{
+    int id;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ProfileScope(const int _id) : id{_id}, start{Profiler::now()}
+    {
+    };
+
+    ~ProfileScope()
+    {
+        Profiler::get().add(id, std::chrono::duration<double, std::milli>(Profiler::now() - start).count());
+    };
+
+    ProfileScope(const ProfileScope&) = delete;
+
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+// Times the rest of the scope under `name`, the series lookup happens once per call site
+#define PROFILE_SCOPE(name) \
+    static const int PROFILER_CONCAT(profile_id_, __LINE__) = Profiler::get().series_id(name); \
+    const ProfileScope PROFILER_CONCAT(profile_scope_, __LINE__){PROFILER_CONCAT(profile_id_, __LINE__)}
+
+#endif //PROFILER_H
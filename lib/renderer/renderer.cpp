@@ -4,32 +4,61 @@
 
 #include "renderer.h"
 #include <algorithm>
+#include <cmath>
 #include <SDL_ttf.h>
 
+static constexpr float PI{3.14159265358979f};
+
+// Signed distance based coverage of pixel (px, py) for a w x h sprite, 0 outside and 1 inside
+static float sprite_coverage(const sprite_t& sprite, const int px, const int py)
+{
+    const float x = static_cast<float>(px) + 0.5f - static_cast<float>(sprite.w) * 0.5f;
+    const float y = static_cast<float>(py) + 0.5f - static_cast<float>(sprite.h) * 0.5f;
+
+    float distance = 0.0f;
+    switch (sprite.shape)
+    {
+    case sprite::ROUNDED_RECT:
+        {
+            const float qx = std::fabs(x) - (static_cast<float>(sprite.w) * 0.5f - sprite.r);
+            const float qy = std::fabs(y) - (static_cast<float>(sprite.h) * 0.5f - sprite.r);
+            const float ox = std::max(qx, 0.0f);
+            const float oy = std::max(qy, 0.0f);
+            distance = std::sqrt(ox * ox + oy * oy) + std::min(std::max(qx, qy), 0.0f) - sprite.r;
+            break;
+        }
+    case sprite::FILLED_CIRCLE:
+        {
+            distance = std::sqrt(x * x + y * y) - sprite.r;
+            break;
+        }
+    case sprite::RING:
+        {
+            const float mid = sprite.r - sprite.thickness * 0.5f;
+            distance = std::fabs(std::sqrt(x * x + y * y) - mid) - sprite.thickness * 0.5f;
+            break;
+        }
+    }
+
+    return std::min(1.0f, std::max(0.0f, 0.5f - distance));
+}
+
 void Renderer::draw_rect(const SDL_FRect rect, const SDL_Color color) const
 {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
     SDL_RenderFillRectF(renderer, &rect);
+    ++draw_calls;
 }
 
 void Renderer::draw_txt(const SDL_Rect pos, const SDL_Color color, const char* txt) const
 {
     if (!txt) return;
 
-    SDL_Surface* surface_msg = TTF_RenderText_Solid(font, txt, color);
-    if (!surface_msg) return;
+    const cached_text_t* cached = cache_text(txt, color);
+    if (!cached) return;
 
-    SDL_Texture* text_texture = SDL_CreateTextureFromSurface(renderer, surface_msg);
-    if (!text_texture)
-    {
-        SDL_FreeSurface(surface_msg);
-        return;
-    }
-
-    SDL_RenderCopy(renderer, text_texture, nullptr, &pos);
-
-    SDL_FreeSurface(surface_msg);
-    SDL_DestroyTexture(text_texture);
+    SDL_RenderCopy(renderer, cached->texture, nullptr, &pos);
+    ++draw_calls;
 }
 
 void Renderer::draw_txt_centered(const SDL_Rect bounds,
@@ -40,18 +69,474 @@ void Renderer::draw_txt_centered(const SDL_Rect bounds,
     if (!txt) return;
     if (bounds.w <= 0 || bounds.h <= 0) return;
 
+    const cached_text_t* cached = cache_text(txt, color);
+    if (!cached) return;
+
+    const SDL_FRect fitted = fit_centered(bounds, cached->w, cached->h, user_scale);
+    const SDL_Rect dst = {
+        static_cast<int>(fitted.x), static_cast<int>(fitted.y),
+        static_cast<int>(fitted.w), static_cast<int>(fitted.h)
+    };
+
+    SDL_RenderCopy(renderer, cached->texture, nullptr, &dst);
+    ++draw_calls;
+}
+
+const cached_text_t* Renderer::cache_text(const char* txt, const SDL_Color color) const
+{
+    if (!txt) return nullptr;
+
+    // FNV-1a over the text, then the colour and size
+    uint64_t key = 14695981039346656037ull;
+    for (const char* c = txt; *c; ++c)
+    {
+        key = (key ^ static_cast<uint8_t>(*c)) * 1099511628211ull;
+    }
+    const uint32_t packed_color = (static_cast<uint32_t>(color.r) << 24) | (static_cast<uint32_t>(color.g) << 16) |
+        (static_cast<uint32_t>(color.b) << 8) | color.a;
+    key = (key ^ packed_color) * 1099511628211ull;
+    key = (key ^ static_cast<uint32_t>(font_size)) * 1099511628211ull;
+
+    const auto it = text_cache.find(key);
+    if (it != text_cache.end())
+    {
+        const cached_text_t& cached = it->second;
+        if (cached.size == font_size && cached.text == txt &&
+            cached.color.r == color.r && cached.color.g == color.g &&
+            cached.color.b == color.b && cached.color.a == color.a)
+        {
+            ++text_cache_hits;
+            return &cached;
+        }
+
+        // Hash collision, the newer string takes the slot
+        SDL_DestroyTexture(cached.texture);
+        text_cache.erase(it);
+    }
+
+    ++text_cache_misses;
+
     SDL_Surface* surface_msg = TTF_RenderText_Solid(font, txt, color);
-    if (!surface_msg) return;
+    if (!surface_msg) return nullptr;
 
     SDL_Texture* text_texture = SDL_CreateTextureFromSurface(renderer, surface_msg);
-    if (!text_texture)
+    const int w = surface_msg->w;
+    const int h = surface_msg->h;
+    SDL_FreeSurface(surface_msg);
+
+    if (!text_texture) return nullptr;
+
+    if (text_cache.size() >= MAX_CACHED_TEXTS)
+    {
+        clear_text_cache();
+    }
+
+    const auto inserted = text_cache.emplace(key, cached_text_t{text_texture, w, h, color, font_size, txt});
+    return &inserted.first->second;
+}
+
+void Renderer::clear_cache() const
+{
+    clear_text_cache();
+
+    if (atlas)
+    {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+    atlas_dirty = !sprites.empty();
+}
+
+void Renderer::clear_text_cache() const
+{
+    // Queued quads may still point at cached textures
+    flush_batch();
+
+    for (const auto& [key, cached] : text_cache)
+    {
+        SDL_DestroyTexture(cached.texture);
+    }
+    text_cache.clear();
+}
+
+void Renderer::cache_rounded_rect(const int w, const int h, const float r) const
+{
+    add_sprite(sprite::ROUNDED_RECT, w, h, r, 0.0f);
+}
+
+void Renderer::cache_filled_circle(const float r) const
+{
+    const int size = static_cast<int>(std::ceil(2.0f * r));
+    add_sprite(sprite::FILLED_CIRCLE, size, size, r, 0.0f);
+}
+
+void Renderer::cache_ring(const float r, const float thickness) const
+{
+    const int size = static_cast<int>(std::ceil(2.0f * r));
+    add_sprite(sprite::RING, size, size, r, thickness);
+}
+
+size_t Renderer::get_sprite_count() const
+{
+    return sprites.size();
+}
+
+void Renderer::add_sprite(const sprite::SHAPE shape, const int w, const int h, const float r,
+                          const float thickness) const
+{
+    if (w <= 0 || h <= 0 || w > ATLAS_WIDTH) return;
+
+    for (const auto& cached : sprites)
+    {
+        if (cached.shape == shape && cached.w == w && cached.h == h &&
+            cached.r == r && cached.thickness == thickness)
+        {
+            return;
+        }
+    }
+
+    // Clamp the radius the same way the procedural path does
+    const float rad = shape == sprite::ROUNDED_RECT
+                          ? std::max(0.0f, std::min(r, std::min(w, h) * 0.5f))
+                          : r;
+
+    sprites.push_back({shape, w, h, rad, thickness, {0, 0, 0, 0}});
+    atlas_dirty = true;
+}
+
+const sprite_t* Renderer::find_sprite(const sprite::SHAPE shape, const int w, const int h, const float r,
+                                      const float thickness) const
+{
+    if (sprites.empty()) return nullptr;
+
+    const sprite_t* found = nullptr;
+    for (const auto& cached : sprites)
+    {
+        if (cached.shape != shape || cached.thickness != thickness) continue;
+
+        // Circles are matched by radius alone, rects by size and clamped radius
+        const bool same_size = shape == sprite::ROUNDED_RECT
+                                   ? cached.w == w && cached.h == h &&
+                                   cached.r == std::max(0.0f, std::min(r, std::min(w, h) * 0.5f))
+                                   : cached.r == r;
+        if (same_size)
+        {
+            found = &cached;
+            break;
+        }
+    }
+
+    if (!found) return nullptr;
+    if ((atlas_dirty || !atlas) && !build_atlas()) return nullptr;
+
+    return found;
+}
+
+bool Renderer::build_atlas() const
+{
+    // Pending quads may reference the old atlas
+    flush_batch();
+
+    if (atlas)
+    {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+    atlas_dirty = false;
+
+    // Shelf packing, tallest sprites first, one pixel of padding against bleeding
+    std::vector<sprite_t*> order;
+    order.reserve(sprites.size());
+    for (auto& cached : sprites)
+    {
+        order.push_back(&cached);
+    }
+    std::sort(order.begin(), order.end(), [](const sprite_t* a, const sprite_t* b) { return a->h > b->h; });
+
+    constexpr int padding = 1;
+    int x = 0;
+    int y = 0;
+    int shelf_h = 0;
+    for (sprite_t* cached : order)
+    {
+        if (x + cached->w > ATLAS_WIDTH)
+        {
+            x = 0;
+            y += shelf_h + padding;
+            shelf_h = 0;
+        }
+
+        cached->src = {x, y, cached->w, cached->h};
+        x += cached->w + padding;
+        shelf_h = std::max(shelf_h, cached->h);
+    }
+    atlas_height = std::max(1, y + shelf_h);
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, atlas_height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to create sprite atlas surface: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_LockSurface(surface);
+    auto* pixels = static_cast<uint8_t*>(surface->pixels);
+    for (int row = 0; row < atlas_height; ++row)
+    {
+        std::fill_n(pixels + static_cast<size_t>(row) * surface->pitch, ATLAS_WIDTH * 4, uint8_t{0});
+    }
+
+    // White texels with the shape coverage in alpha, the draw colour tints them
+    for (const auto& cached : sprites)
+    {
+        for (int py = 0; py < cached.h; ++py)
+        {
+            uint8_t* row = pixels + static_cast<size_t>(cached.src.y + py) * surface->pitch + cached.src.x * 4;
+            for (int px = 0; px < cached.w; ++px)
+            {
+                row[px * 4 + 0] = 255;
+                row[px * 4 + 1] = 255;
+                row[px * 4 + 2] = 255;
+                row[px * 4 + 3] = static_cast<uint8_t>(sprite_coverage(cached, px, py) * 255.0f + 0.5f);
+            }
+        }
+    }
+    SDL_UnlockSurface(surface);
+
+    atlas = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+
+    if (!atlas)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to create sprite atlas: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void Renderer::draw_sprite(const sprite_t& sprite, const SDL_FRect dst, const SDL_Color color) const
+{
+    SDL_SetTextureColorMod(atlas, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(atlas, color.a);
+    SDL_RenderCopyF(renderer, atlas, &sprite.src, &dst);
+    ++draw_calls;
+}
+
+void Renderer::batch_sprite(const sprite_t& sprite, const SDL_FRect dst, const SDL_Color color) const
+{
+    const float u0 = static_cast<float>(sprite.src.x) / ATLAS_WIDTH;
+    const float v0 = static_cast<float>(sprite.src.y) / static_cast<float>(atlas_height);
+    const float u1 = static_cast<float>(sprite.src.x + sprite.src.w) / ATLAS_WIDTH;
+    const float v1 = static_cast<float>(sprite.src.y + sprite.src.h) / static_cast<float>(atlas_height);
+
+    geometry_batch_t& batch = get_batch(atlas);
+    const int base = static_cast<int>(batch.vertices.size());
+
+    batch.vertices.push_back({{dst.x, dst.y}, color, {u0, v0}});
+    batch.vertices.push_back({{dst.x + dst.w, dst.y}, color, {u1, v0}});
+    batch.vertices.push_back({{dst.x + dst.w, dst.y + dst.h}, color, {u1, v1}});
+    batch.vertices.push_back({{dst.x, dst.y + dst.h}, color, {u0, v1}});
+
+    const int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+    batch.indices.insert(batch.indices.end(), quad, quad + 6);
+}
+
+void Renderer::batch_rect(const SDL_FRect rect, const SDL_Color color) const
+{
+    geometry_batch_t& batch = get_batch(nullptr);
+    const int base = static_cast<int>(batch.vertices.size());
+
+    batch.vertices.push_back({{rect.x, rect.y}, color, {0, 0}});
+    batch.vertices.push_back({{rect.x + rect.w, rect.y}, color, {0, 0}});
+    batch.vertices.push_back({{rect.x + rect.w, rect.y + rect.h}, color, {0, 0}});
+    batch.vertices.push_back({{rect.x, rect.y + rect.h}, color, {0, 0}});
+
+    const int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+    batch.indices.insert(batch.indices.end(), quad, quad + 6);
+}
+
+void Renderer::batch_heat(const SDL_FRect rect, const float probability, const uint8_t alpha) const
+{
+    const float p = std::min(1.0f, std::max(0.0f, probability));
+    const auto red = static_cast<uint8_t>(255.0f * std::min(1.0f, 2.0f * p));
+    const auto green = static_cast<uint8_t>(255.0f * std::min(1.0f, 2.0f * (1.0f - p)));
+
+    batch_rect(rect, {red, green, 0, alpha});
+}
+
+void Renderer::batch_rounded_rect(const SDL_FRect rect, const float r, const SDL_Color color) const
+{
+    if (rect.w <= 0 || rect.h <= 0) return;
+
+    if (const sprite_t* cached = find_sprite(sprite::ROUNDED_RECT, static_cast<int>(rect.w),
+                                             static_cast<int>(rect.h), r, 0.0f))
     {
-        SDL_FreeSurface(surface_msg);
+        batch_sprite(*cached, rect, color);
         return;
     }
 
-    const int text_w = std::max(1, surface_msg->w);
-    const int text_h = std::max(1, surface_msg->h);
+    const float max_r = std::min(rect.w, rect.h) * 0.5f;
+    const float rad = std::max(0.0f, std::min(r, max_r));
+    if (rad <= 0.0f)
+    {
+        batch_rect(rect, color);
+        return;
+    }
+
+    geometry_batch_t& batch = get_batch(nullptr);
+    const int center = static_cast<int>(batch.vertices.size());
+
+    batch.vertices.push_back({{rect.x + rect.w * 0.5f, rect.y + rect.h * 0.5f}, color, {0, 0}});
+
+    // Convex outline, corner arcs clockwise from the top right, fanned from the centre
+    const SDL_FPoint corners[4] = {
+        {rect.x + rect.w - rad, rect.y + rad},
+        {rect.x + rect.w - rad, rect.y + rect.h - rad},
+        {rect.x + rad, rect.y + rect.h - rad},
+        {rect.x + rad, rect.y + rad},
+    };
+
+    constexpr float quarter = PI * 0.5f;
+    for (int c = 0; c < 4; ++c)
+    {
+        const float start = -quarter + static_cast<float>(c) * quarter;
+        for (int k = 0; k <= CORNER_SEGMENTS; ++k)
+        {
+            const float angle = start + quarter * static_cast<float>(k) / CORNER_SEGMENTS;
+            batch.vertices.push_back({
+                {corners[c].x + std::cos(angle) * rad, corners[c].y + std::sin(angle) * rad}, color, {0, 0}
+            });
+        }
+    }
+
+    const int outline = 4 * (CORNER_SEGMENTS + 1);
+    for (int k = 0; k < outline; ++k)
+    {
+        const int next = (k + 1) % outline;
+        const int tri[3] = {center, center + 1 + k, center + 1 + next};
+        batch.indices.insert(batch.indices.end(), tri, tri + 3);
+    }
+}
+
+void Renderer::batch_ring(const circle_t circle, const float thickness, const SDL_Color color) const
+{
+    if (circle.r <= 0.0f) return;
+
+    if (const sprite_t* cached = find_sprite(sprite::RING, 0, 0, circle.r, thickness))
+    {
+        batch_sprite(*cached, {circle.center_x - cached->w * 0.5f, circle.center_y - cached->h * 0.5f,
+                               static_cast<float>(cached->w), static_cast<float>(cached->h)}, color);
+        return;
+    }
+
+    geometry_batch_t& batch = get_batch(nullptr);
+    const int base = static_cast<int>(batch.vertices.size());
+
+    const float inner = std::max(0.0f, circle.r - thickness);
+    for (int k = 0; k < RING_SEGMENTS; ++k)
+    {
+        const float angle = 2.0f * PI * static_cast<float>(k) / RING_SEGMENTS;
+        const float cos_a = std::cos(angle);
+        const float sin_a = std::sin(angle);
+
+        batch.vertices.push_back({
+            {circle.center_x + cos_a * circle.r, circle.center_y + sin_a * circle.r}, color, {0, 0}
+        });
+        batch.vertices.push_back({
+            {circle.center_x + cos_a * inner, circle.center_y + sin_a * inner}, color, {0, 0}
+        });
+    }
+
+    for (int k = 0; k < RING_SEGMENTS; ++k)
+    {
+        const int outer_a = base + 2 * k;
+        const int inner_a = outer_a + 1;
+        const int outer_b = base + 2 * ((k + 1) % RING_SEGMENTS);
+        const int inner_b = outer_b + 1;
+
+        const int quad[6] = {outer_a, outer_b, inner_b, outer_a, inner_b, inner_a};
+        batch.indices.insert(batch.indices.end(), quad, quad + 6);
+    }
+}
+
+void Renderer::batch_txt_centered(const SDL_Rect bounds,
+                                  const SDL_Color color,
+                                  const char* txt,
+                                  const float user_scale) const
+{
+    if (!txt) return;
+    if (bounds.w <= 0 || bounds.h <= 0) return;
+
+    const cached_text_t* cached = cache_text(txt, color);
+    if (!cached) return;
+
+    const SDL_FRect dst = fit_centered(bounds, cached->w, cached->h, user_scale);
+
+    // The colour is already baked into the texture
+    constexpr SDL_Color white = {255, 255, 255, 255};
+
+    geometry_batch_t& batch = get_batch(cached->texture);
+    const int base = static_cast<int>(batch.vertices.size());
+
+    batch.vertices.push_back({{dst.x, dst.y}, white, {0.0f, 0.0f}});
+    batch.vertices.push_back({{dst.x + dst.w, dst.y}, white, {1.0f, 0.0f}});
+    batch.vertices.push_back({{dst.x + dst.w, dst.y + dst.h}, white, {1.0f, 1.0f}});
+    batch.vertices.push_back({{dst.x, dst.y + dst.h}, white, {0.0f, 1.0f}});
+
+    const int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+    batch.indices.insert(batch.indices.end(), quad, quad + 6);
+}
+
+void Renderer::flush_batch() const
+{
+    // Plain geometry is always batches[0], so textured quads land on top of it
+    for (auto& batch : batches)
+    {
+        if (!batch.indices.empty())
+        {
+            SDL_RenderGeometry(renderer, batch.texture,
+                               batch.vertices.data(), static_cast<int>(batch.vertices.size()),
+                               batch.indices.data(), static_cast<int>(batch.indices.size()));
+            ++draw_calls;
+        }
+
+        batch.vertices.clear();
+        batch.indices.clear();
+    }
+}
+
+geometry_batch_t& Renderer::get_batch(SDL_Texture* texture) const
+{
+    if (batches.empty())
+    {
+        batches.push_back({nullptr, {}, {}});
+    }
+
+    for (auto& batch : batches)
+    {
+        if (batch.texture == texture) return batch;
+    }
+
+    // Reuse a drained slot before growing, textures come and go with the text cache
+    for (size_t i = 1; i < batches.size(); ++i)
+    {
+        if (batches[i].indices.empty())
+        {
+            batches[i].texture = texture;
+            return batches[i];
+        }
+    }
+
+    batches.push_back({texture, {}, {}});
+    return batches.back();
+}
+
+SDL_FRect Renderer::fit_centered(const SDL_Rect bounds, const int w, const int h, const float user_scale)
+{
+    const int text_w = std::max(1, w);
+    const int text_h = std::max(1, h);
 
     const float fit_scale_w = static_cast<float>(bounds.w) / static_cast<float>(text_w);
     const float fit_scale_h = static_cast<float>(bounds.h) / static_cast<float>(text_h);
@@ -62,20 +547,100 @@ void Renderer::draw_txt_centered(const SDL_Rect bounds,
 
     if (final_scale > fit_scale) final_scale = fit_scale;
 
-    SDL_Rect dst{};
-    dst.w = std::max(1, static_cast<int>(text_w * final_scale));
-    dst.h = std::max(1, static_cast<int>(text_h * final_scale));
-    dst.x = bounds.x + (bounds.w - dst.w) / 2;
-    dst.y = bounds.y + (bounds.h - dst.h) / 2;
+    SDL_FRect dst{};
+    dst.w = static_cast<float>(std::max(1, static_cast<int>(text_w * final_scale)));
+    dst.h = static_cast<float>(std::max(1, static_cast<int>(text_h * final_scale)));
+    dst.x = static_cast<float>(bounds.x + (bounds.w - static_cast<int>(dst.w)) / 2);
+    dst.y = static_cast<float>(bounds.y + (bounds.h - static_cast<int>(dst.h)) / 2);
+
+    return dst;
+}
+
+float Renderer::batch_glyphs(const float x, const float y, const float h, const SDL_Color color,
+                             const char* txt) const
+{
+    if (!txt || h <= 0.0f) return 0.0f;
 
-    SDL_RenderCopy(renderer, text_texture, nullptr, &dst);
+    constexpr SDL_Color white = {255, 255, 255, 255};
 
-    SDL_FreeSurface(surface_msg);
-    SDL_DestroyTexture(text_texture);
+    float pen = x;
+    char glyph[2] = {0, 0};
+    for (const char* c = txt; *c; ++c)
+    {
+        // Fonts render nothing for a lone space
+        if (*c == ' ')
+        {
+            pen += h * 0.3f;
+            continue;
+        }
+
+        glyph[0] = *c;
+        const cached_text_t* cached = cache_text(glyph, color);
+        if (!cached || cached->h <= 0) continue;
+
+        const float w = static_cast<float>(cached->w) * h / static_cast<float>(cached->h);
+
+        geometry_batch_t& batch = get_batch(cached->texture);
+        const int base = static_cast<int>(batch.vertices.size());
+
+        batch.vertices.push_back({{pen, y}, white, {0.0f, 0.0f}});
+        batch.vertices.push_back({{pen + w, y}, white, {1.0f, 0.0f}});
+        batch.vertices.push_back({{pen + w, y + h}, white, {1.0f, 1.0f}});
+        batch.vertices.push_back({{pen, y + h}, white, {0.0f, 1.0f}});
+
+        const int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        batch.indices.insert(batch.indices.end(), quad, quad + 6);
+
+        pen += w;
+    }
+
+    return pen - x;
+}
+
+void Renderer::add_draw_calls(const uint32_t count) const
+{
+    draw_calls += count;
+}
+
+void Renderer::reset_frame_stats() const
+{
+    draw_calls = 0;
+}
+
+uint32_t Renderer::get_draw_calls() const
+{
+    return draw_calls;
+}
+
+size_t Renderer::get_texture_count() const
+{
+    return text_cache.size() + (atlas ? 1 : 0);
+}
+
+size_t Renderer::get_cached_text_count() const
+{
+    return text_cache.size();
+}
+
+uint64_t Renderer::get_text_cache_hits() const
+{
+    return text_cache_hits;
+}
+
+uint64_t Renderer::get_text_cache_misses() const
+{
+    return text_cache_misses;
 }
 
 void Renderer::draw_circle(const circle_t circle, const SDL_Color color) const
 {
+    if (const sprite_t* cached = find_sprite(sprite::RING, 0, 0, circle.r, 1.0f))
+    {
+        draw_sprite(*cached, {circle.center_x - cached->w * 0.5f, circle.center_y - cached->h * 0.5f,
+                              static_cast<float>(cached->w), static_cast<float>(cached->h)}, color);
+        return;
+    }
+
     float x = circle.r - 1;
     float y = 0;
 
@@ -96,6 +661,7 @@ void Renderer::draw_circle(const circle_t circle, const SDL_Color color) const
         SDL_RenderDrawPointF(renderer, circle.center_x + y, circle.center_y + x);
         SDL_RenderDrawPointF(renderer, circle.center_x - y, circle.center_y - x);
         SDL_RenderDrawPointF(renderer, circle.center_x - y, circle.center_y + x);
+        draw_calls += 8;
 
         if (err <= 0)
         {
@@ -115,6 +681,13 @@ void Renderer::draw_circle(const circle_t circle, const SDL_Color color) const
 
 void Renderer::draw_filled_circle(const circle_t circle, const SDL_Color color) const
 {
+    if (const sprite_t* cached = find_sprite(sprite::FILLED_CIRCLE, 0, 0, circle.r, 0.0f))
+    {
+        draw_sprite(*cached, {circle.center_x - cached->w * 0.5f, circle.center_y - cached->h * 0.5f,
+                              static_cast<float>(cached->w), static_cast<float>(cached->h)}, color);
+        return;
+    }
+
     float x = circle.r - 1;
     float y = 0;
 
@@ -134,6 +707,7 @@ void Renderer::draw_filled_circle(const circle_t circle, const SDL_Color color)
         SDL_RenderDrawLineF(renderer, center_x - x, center_y - y, center_x + x, center_y - y);
         SDL_RenderDrawLineF(renderer, center_x - y, center_y + x, center_x + y, center_y + x);
         SDL_RenderDrawLineF(renderer, center_x - y, center_y - x, center_x + y, center_y - x);
+        draw_calls += 4;
 
         if (err <= 0)
         {
@@ -156,6 +730,13 @@ const
 {
     if (rect.w <= 0 || rect.h <= 0) return;
 
+    if (const sprite_t* cached = find_sprite(sprite::ROUNDED_RECT, static_cast<int>(rect.w),
+                                             static_cast<int>(rect.h), r, 0.0f))
+    {
+        draw_sprite(*cached, rect, color);
+        return;
+    }
+
     const float max_r = std::min(rect.w, rect.h) * 0.5f;
     const float rad = std::max(0.0f, std::min(r, max_r));
 
@@ -169,6 +750,7 @@ const
 
     const SDL_FRect right_strip = {rect.x + rect.w - rad, rect.y + rad, rad, rect.h - 2.0f * rad};
     if (right_strip.w > 0 && right_strip.h > 0) SDL_RenderFillRectF(renderer, &right_strip);
+    draw_calls += 3;
 
     if (rad <= 0.0f) { return; }
     {
@@ -8,6 +8,11 @@
 #include <SDL2/SDL.h>
 #include <SDL_ttf.h>
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 typedef struct CIRCLE
 {
     float center_x;
@@ -15,17 +20,87 @@ typedef struct CIRCLE
     float r;
 } circle_t;
 
+typedef struct CACHED_TEXT
+{
+    SDL_Texture* texture;
+    int w;
+    int h;
+    SDL_Color color;
+    int size;
+    std::string text;
+} cached_text_t;
+
+namespace sprite
+{
+    enum SHAPE
+    {
+        ROUNDED_RECT,
+        FILLED_CIRCLE,
+        RING,
+    };
+}
+
+// Shape rasterised once into the atlas as white coverage, tinted when drawn
+typedef struct SPRITE
+{
+    sprite::SHAPE shape;
+    int w;
+    int h;
+    float r;
+    float thickness;
+    SDL_Rect src;
+} sprite_t;
+
+// Triangles queued for one texture, nullptr for plain coloured geometry
+typedef struct GEOMETRY_BATCH
+{
+    SDL_Texture* texture;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+} geometry_batch_t;
+
 class Renderer
 {
     SDL_Renderer* renderer;
     TTF_Font* font;
+    int font_size{0};
+
+    // Rasterised strings keyed by text, colour and font size, textures belong to `renderer`
+    mutable std::unordered_map<uint64_t, cached_text_t> text_cache;
+    mutable uint64_t text_cache_hits{0};
+    mutable uint64_t text_cache_misses{0};
+
+    // Dropped wholesale when reached, keeps ever changing strings from piling up textures
+    static constexpr size_t MAX_CACHED_TEXTS{256};
+
+    // One batch per texture, buffers keep their capacity between frames
+    mutable std::vector<geometry_batch_t> batches;
+
+    // Pre-rasterised shapes, the atlas texture is rebuilt lazily after a shape is added
+    mutable std::vector<sprite_t> sprites;
+    mutable SDL_Texture* atlas{nullptr};
+    mutable bool atlas_dirty{false};
+    mutable int atlas_height{0};
+
+    static constexpr int ATLAS_WIDTH{1024};
+
+    // Segments per rounded corner and per ring when tessellating
+    static constexpr int CORNER_SEGMENTS{6};
+    static constexpr int RING_SEGMENTS{24};
+
+    // SDL draw calls issued since reset_frame_stats
+    mutable uint32_t draw_calls{0};
 
 public:
     Renderer(SDL_Renderer* _renderer, TTF_Font* _font) : renderer{_renderer}, font{_font}
     {
+        font_size = font ? TTF_FontHeight(font) : 0;
     };
 
-    ~Renderer() = default;
+    ~Renderer()
+    {
+        clear_cache();
+    };
 
 public:
     void draw_rect(SDL_FRect rect, SDL_Color color) const;
@@ -39,6 +114,75 @@ public:
     void draw_filled_circle(circle_t circle, SDL_Color color) const;
 
     void draw_rounded_rect(SDL_FRect rect, float r, SDL_Color color) const;
+
+    // Batched drawing: shapes are queued and submitted with one SDL_RenderGeometry call per texture
+    void batch_rect(SDL_FRect rect, SDL_Color color) const;
+
+    void batch_rounded_rect(SDL_FRect rect, float r, SDL_Color color) const;
+
+    void batch_ring(circle_t circle, float thickness, SDL_Color color) const;
+
+    void batch_txt_centered(SDL_Rect bounds, SDL_Color color, const char* txt, float user_scale) const;
+
+    // Heat map cell, green at probability 0 through yellow to red at 1
+    void batch_heat(SDL_FRect rect, float probability, uint8_t alpha) const;
+
+    void flush_batch() const;
+
+    // Queues txt one cached glyph at a time, h pixels tall from (x, y). Returns the advance.
+    // Ever changing strings such as timings then reuse a fixed set of textures.
+    float batch_glyphs(float x, float y, float h, SDL_Color color, const char* txt) const;
+
+    // Registers shapes for the sprite atlas, draws of exactly that size become one textured quad.
+    // Other sizes keep using the procedural path.
+    void cache_rounded_rect(int w, int h, float r) const;
+
+    void cache_filled_circle(float r) const;
+
+    void cache_ring(float r, float thickness) const;
+
+    // Rasterises txt once so later draws of the same text and colour reuse the texture
+    const cached_text_t* cache_text(const char* txt, SDL_Color color) const;
+
+    // Frees every cached texture, must run before the SDL_Renderer is destroyed
+    void clear_cache() const;
+
+    // For draws made straight through the SDL_Renderer
+    void add_draw_calls(uint32_t count) const;
+
+    void reset_frame_stats(void) const;
+
+    [[nodiscard]] uint32_t get_draw_calls(void) const;
+
+    // Textures owned by the renderer, cached texts plus the atlas
+    [[nodiscard]] size_t get_texture_count(void) const;
+
+    [[nodiscard]] size_t get_sprite_count(void) const;
+
+    [[nodiscard]] size_t get_cached_text_count(void) const;
+
+    [[nodiscard]] uint64_t get_text_cache_hits(void) const;
+
+    [[nodiscard]] uint64_t get_text_cache_misses(void) const;
+
+private:
+    geometry_batch_t& get_batch(SDL_Texture* texture) const;
+
+    void clear_text_cache() const;
+
+    void add_sprite(sprite::SHAPE shape, int w, int h, float r, float thickness) const;
+
+    // Exact size match or nullptr, builds the atlas on first use
+    const sprite_t* find_sprite(sprite::SHAPE shape, int w, int h, float r, float thickness) const;
+
+    bool build_atlas() const;
+
+    void draw_sprite(const sprite_t& sprite, SDL_FRect dst, SDL_Color color) const;
+
+    void batch_sprite(const sprite_t& sprite, SDL_FRect dst, SDL_Color color) const;
+
+    // Where a w x h texture lands when fitted and centred in bounds
+    static SDL_FRect fit_centered(SDL_Rect bounds, int w, int h, float user_scale);
 };
 
 #endif //RENDERER_H
@@ -0,0 +1,97 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "resource_cache.h"
+
+#include <SDL2/SDL_log.h>
+
+ResourceCache::~ResourceCache()
+{
+    clear();
+}
+
+SDL_Cursor* ResourceCache::get_cursor(const SDL_SystemCursor id)
+{
+    if (id < 0 || id >= SDL_NUM_SYSTEM_CURSORS) return nullptr;
+
+    if (!cursors[id])
+    {
+        cursors[id] = SDL_CreateSystemCursor(id);
+        if (!cursors[id])
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_CreateSystemCursor(%d) failed: %s", id, SDL_GetError());
+        }
+    }
+
+    return cursors[id];
+}
+
+void ResourceCache::set_cursor(const SDL_SystemCursor id)
+{
+    if (id == active_cursor) return;
+
+    SDL_Cursor* cursor = get_cursor(id);
+    if (!cursor) return;
+
+    SDL_SetCursor(cursor);
+    active_cursor = id;
+}
+
+TTF_Font* ResourceCache::get_font(const char* path, const int size)
+{
+    for (const font_entry_t& entry : fonts)
+    {
+        if (entry.size == size && entry.path == path) return entry.font;
+    }
+
+    TTF_Font* font = TTF_OpenFont(path, size);
+    if (!font)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_OpenFont('%s') failed: %s", path, TTF_GetError());
+        return nullptr;
+    }
+
+    fonts.push_back({path, size, font});
+    return font;
+}
+
+void ResourceCache::clear()
+{
+    // SDL keeps using the active cursor until another one is set, restore the default first
+    if (active_cursor != SDL_NUM_SYSTEM_CURSORS)
+    {
+        SDL_SetCursor(SDL_GetDefaultCursor());
+        active_cursor = SDL_NUM_SYSTEM_CURSORS;
+    }
+
+    for (SDL_Cursor*& cursor : cursors)
+    {
+        if (cursor)
+        {
+            SDL_FreeCursor(cursor);
+            cursor = nullptr;
+        }
+    }
+
+    for (const font_entry_t& entry : fonts)
+    {
+        TTF_CloseFont(entry.font);
+    }
+    fonts.clear();
+}
+
+size_t ResourceCache::get_cursor_count() const
+{
+    size_t count = 0;
+    for (const SDL_Cursor* cursor : cursors)
+    {
+        if (cursor) ++count;
+    }
+    return count;
+}
+
+size_t ResourceCache::get_font_count() const
+{
+    return fonts.size();
+}
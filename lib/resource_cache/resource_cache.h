@@ -0,0 +1,57 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+#include <SDL2/SDL_mouse.h>
+#include <SDL_ttf.h>
+
+#include <string>
+#include <vector>
+
+// Long lived SDL handles created on first use and freed together.
+// Owned by Window, cleared before SDL and TTF shut down.
+class ResourceCache
+{
+    typedef struct FONT_ENTRY
+    {
+        std::string path;
+        int size;
+        TTF_Font* font;
+    } font_entry_t;
+
+    SDL_Cursor* cursors[SDL_NUM_SYSTEM_CURSORS]{};
+    // Cursor last handed to SDL_SetCursor, SDL_NUM_SYSTEM_CURSORS while none was
+    SDL_SystemCursor active_cursor{SDL_NUM_SYSTEM_CURSORS};
+
+    std::vector<font_entry_t> fonts;
+
+public:
+    ResourceCache() = default;
+
+    ~ResourceCache();
+
+    ResourceCache(const ResourceCache&) = delete;
+
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+public:
+    // Creates the system cursor once, nullptr when SDL cannot
+    SDL_Cursor* get_cursor(SDL_SystemCursor id);
+
+    // Applies the cursor only when it differs from the active one
+    void set_cursor(SDL_SystemCursor id);
+
+    // Opens path at size once, later calls return the same handle
+    TTF_Font* get_font(const char* path, int size);
+
+    // Frees every handle, must run before TTF_Quit / SDL_Quit
+    void clear(void);
+
+    [[nodiscard]] size_t get_cursor_count(void) const;
+
+    [[nodiscard]] size_t get_font_count(void) const;
+};
+
+#endif //RESOURCE_CACHE_H
@@ -4,13 +4,16 @@
 
 #include <algorithm>
 #include <iomanip>
-#include <sstream>
 #include <cctype>
+#include <cstdio>
 
 #include <score_manager.h>
 #include <renderer.h>
+#include <trace.h>
 
 std::string ScoreManager::open_score_window(TTF_Font *font) {
+    TRACE_ZONE("score_window");
+
     SDL_Window *score_window = SDL_CreateWindow(
         platform::window::score::TITLE,
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -32,10 +35,31 @@ std::string ScoreManager::open_score_window(TTF_Font *font) {
 
     Renderer renderer{score_renderer, font};
 
+    // Input prompt box
+    constexpr SDL_FRect box{
+        20.0f, static_cast<float>(platform::window::score::HEIGHT - 100),
+        static_cast<float>(platform::window::score::WIDTH - 40), 60.0f
+    };
+    constexpr float box_radius = 8.0f;
+    renderer.cache_rounded_rect(static_cast<int>(box.w), static_cast<int>(box.h), box_radius);
+
     std::string input_name{};
     constexpr size_t max_name_len = 20;
+    input_name.reserve(max_name_len);
     bool running = true;
 
+    // The leaderboard does not change while the window is open, format it once
+    char lines[platform::file::MAX_SCORES_SAVED][64];
+    int line_count = 0;
+    for (const auto &s: score_list) {
+        if (line_count >= platform::file::MAX_SCORES_SAVED) break;
+        std::snprintf(lines[line_count], sizeof(lines[line_count]), "%2d. %s  -  %.2fs",
+                      line_count + 1, s.name.c_str(), s.time);
+        ++line_count;
+    }
+
+    char display[max_name_len + 2];
+
     SDL_StartTextInput();
 
     while (running) {
@@ -81,40 +105,32 @@ std::string ScoreManager::open_score_window(TTF_Font *font) {
         renderer.draw_txt(title_rect, {255, 255, 255, 255}, "Leaderboard");
 
         int y = 60;
-        int rank = 1;
-        for (const auto &s: score_list) {
-            std::ostringstream line;
-            line << std::setw(2) << rank << ". " << s.name
-                    << "  -  " << std::fixed << std::setprecision(2) << s.time << "s";
+        for (int i = 0; i < line_count; ++i) {
             const SDL_Rect line_rect{30, y, platform::window::score::WIDTH - 60, 22};
-            renderer.draw_txt(line_rect, {200, 200, 200, 255}, line.str().c_str());
+            renderer.draw_txt(line_rect, {200, 200, 200, 255}, lines[i]);
             y += 24;
-            if (rank++ >= platform::file::MAX_SCORES_SAVED) break;
         }
 
-        // Input prompt box
-        constexpr SDL_FRect box{
-            20.0f, static_cast<float>(platform::window::score::HEIGHT - 100),
-            static_cast<float>(platform::window::score::WIDTH - 40), 60.0f
-        };
-        renderer.draw_rounded_rect(box, 8.0f, {48, 48, 48, 255});
+        renderer.draw_rounded_rect(box, box_radius, {48, 48, 48, 255});
         const SDL_Rect prompt_rect{
             static_cast<int>(box.x + 10), static_cast<int>(box.y + 8), static_cast<int>(box.w - 20), 22
         };
         renderer.draw_txt(prompt_rect, {255, 255, 255, 255}, "Enter your name (Enter to save, Esc to cancel):");
 
         // Input text
-        std::string display = input_name.empty() ? std::string("_") : input_name + "_";
+        std::snprintf(display, sizeof(display), "%s_", input_name.c_str());
         const SDL_Rect input_rect{
             static_cast<int>(box.x + 10), static_cast<int>(box.y + 32), static_cast<int>(box.w - 20), 22
         };
-        renderer.draw_txt(input_rect, {180, 220, 180, 255}, display.c_str());
+        renderer.draw_txt(input_rect, {180, 220, 180, 255}, display);
 
         SDL_RenderPresent(score_renderer);
     }
 
     SDL_StopTextInput();
 
+    // Cached text textures belong to score_renderer
+    renderer.clear_cache();
     SDL_DestroyRenderer(score_renderer);
     SDL_DestroyWindow(score_window);
 
@@ -128,6 +144,8 @@ std::string ScoreManager::open_score_window(TTF_Font *font) {
 }
 
 void ScoreManager::save_score(const std::string &name, const float time) {
+    TRACE_ZONE("save_score");
+
     if (score_list.empty()) {
         load_scores();
     }
@@ -175,6 +193,8 @@ void ScoreManager::save_score(const std::string &name, const float time) {
 }
 
 std::vector<score_t> ScoreManager::load_scores() {
+    TRACE_ZONE("load_scores");
+
     std::vector<score_t> scores = {};
 
     std::ifstream file(score_file_dir);
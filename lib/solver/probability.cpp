@@ -0,0 +1,577 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "probability.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "thread_pool.h"
+#include "trace.h"
+
+// Depth first enumeration of one component, constraints are checked as soon as a cell is assigned
+typedef struct ENUMERATOR
+{
+    size_t n;
+    // Assignment order, neighbours first so constraints close early
+    std::vector<uint32_t> order;
+    // Per local cell, the local constraints it appears in
+    std::vector<uint32_t> cell_constraints;
+    std::vector<uint8_t> cell_constraint_count;
+
+    std::vector<int> target;
+    std::vector<int> placed;
+    std::vector<int> open;
+
+    std::vector<uint8_t> assigned;
+    size_t mines;
+    size_t max_mines;
+
+    uint64_t nodes;
+    uint64_t cap;
+    bool aborted;
+
+    double* weights;
+    double* var_weights;
+
+    void run(const size_t depth)
+    {
+        if (++nodes > cap)
+        {
+            aborted = true;
+            return;
+        }
+
+        if (depth == n)
+        {
+            weights[mines] += 1.0;
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (assigned[v]) var_weights[v * (n + 1) + mines] += 1.0;
+            }
+            return;
+        }
+
+        const uint32_t v = order[depth];
+        const uint32_t* cons = &cell_constraints[static_cast<size_t>(v) * 8];
+        const int count = cell_constraint_count[v];
+
+        for (int value = 0; value <= 1; ++value)
+        {
+            if (value == 1 && mines >= max_mines) break;
+
+            bool valid = true;
+            for (int k = 0; k < count; ++k)
+            {
+                const uint32_t c = cons[k];
+                --open[c];
+                placed[c] += value;
+                if (placed[c] > target[c] || placed[c] + open[c] < target[c]) valid = false;
+            }
+
+            if (valid)
+            {
+                assigned[v] = static_cast<uint8_t>(value);
+                mines += static_cast<size_t>(value);
+                run(depth + 1);
+                mines -= static_cast<size_t>(value);
+                assigned[v] = 0;
+            }
+
+            for (int k = 0; k < count; ++k)
+            {
+                const uint32_t c = cons[k];
+                ++open[c];
+                placed[c] -= value;
+            }
+
+            if (aborted) return;
+        }
+    }
+} enumerator_t;
+
+static double log_choose(const size_t n, const size_t k)
+{
+    return std::lgamma(static_cast<double>(n) + 1.0) - std::lgamma(static_cast<double>(k) + 1.0) -
+        std::lgamma(static_cast<double>(n - k) + 1.0);
+}
+
+// Scales v so its largest entry is 1, keeps long products of weights inside double range
+static void normalise(std::vector<double>& v)
+{
+    double top = 0.0;
+    for (const double x : v) top = std::max(top, x);
+    if (top <= 0.0) return;
+    for (double& x : v) x /= top;
+}
+
+static uint32_t find_root(std::vector<uint32_t>& parent, uint32_t v)
+{
+    while (parent[v] != v)
+    {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+void ProbabilityEngine::set_work_cap(const uint64_t _work_cap)
+{
+    work_cap = _work_cap > 0 ? _work_cap : 1;
+}
+
+void ProbabilityEngine::compute(const Board& board, const Solver& solver, int x0, int y0, int x1, int y1)
+{
+    TRACE_ZONE("probability");
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const int cols = board.get_cols();
+    const int rows = board.get_rows();
+    const size_t cells = static_cast<size_t>(cols) * static_cast<size_t>(rows);
+
+    const bool full = cells <= FULL_SCAN_CELLS;
+    if (full)
+    {
+        x0 = 0;
+        y0 = 0;
+        x1 = cols - 1;
+        y1 = rows - 1;
+    }
+
+    collect_frontier(board, solver, std::max(0, x0), std::max(0, y0), std::min(cols - 1, x1),
+                     std::min(rows - 1, y1));
+    split_components();
+
+    // Components split_components left over the exact budget are already approximated
+    const auto enumerate_one = [this](const size_t c) {
+        if (!components[c].approximate) enumerate(components[c]);
+    };
+    if (pool)
+    {
+        pool->parallel_for(components.size(), enumerate_one);
+    }
+    else
+    {
+        for (size_t c = 0; c < components.size(); ++c) enumerate_one(c);
+    }
+
+    // Only what the player can know: deduced mines count, flags do not
+    const size_t known_mines = solver.get_known_mines();
+    const size_t mines = static_cast<size_t>(std::max(0, board.get_mines()));
+    const size_t mines_left = mines > known_mines ? mines - known_mines : 0;
+
+    const size_t closed = cells - board.get_revealed_safe() - known_mines - solver.count_closed_safe(board);
+    const size_t other_cells = closed > frontier.size() ? closed - frontier.size() : 0;
+
+    combine(mines_left, other_cells);
+
+    stats.frontier_cells = frontier.size();
+    stats.constraints = constraints.size();
+    stats.components = components.size();
+    stats.approximate_components = 0;
+    stats.nodes = 0;
+    for (const component_t& component : components)
+    {
+        stats.approximate_components += component.approximate ? 1 : 0;
+        stats.nodes += component.nodes;
+    }
+    stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    exact = full && stats.approximate_components == 0;
+}
+
+float ProbabilityEngine::probability(const Board& board, const Solver& solver, const size_t i) const
+{
+    if (board.is_revealed(i)) return -1.0f;
+    if (solver.is_known_mine(i)) return 1.0f;
+    if (solver.is_known_safe(i)) return 0.0f;
+
+    const auto it = std::lower_bound(frontier.begin(), frontier.end(), static_cast<uint32_t>(i));
+    if (it != frontier.end() && *it == i) return frontier_prob[static_cast<size_t>(it - frontier.begin())];
+
+    return other_prob;
+}
+
+bool ProbabilityEngine::safest_cell(const Board& board, const Solver& solver, const int x0, const int y0,
+                                    const int x1, const int y1, int& x, int& y) const
+{
+    const int cols = board.get_cols();
+    float best = 2.0f;
+
+    for (int cy = std::max(0, y0); cy <= std::min(board.get_rows() - 1, y1); ++cy)
+    {
+        for (int cx = std::max(0, x0); cx <= std::min(cols - 1, x1); ++cx)
+        {
+            const float p = probability(board, solver, board.index(cx, cy));
+            if (p < 0.0f || p >= best) continue;
+
+            best = p;
+            x = cx;
+            y = cy;
+            if (p <= 0.0f) return true;
+        }
+    }
+
+    return best <= 1.0f;
+}
+
+bool ProbabilityEngine::is_exact() const
+{
+    return exact;
+}
+
+const probability_stats_t& ProbabilityEngine::get_stats() const
+{
+    return stats;
+}
+
+void ProbabilityEngine::collect_frontier(const Board& board, const Solver& solver, const int x0, const int y0,
+                                         const int x1, const int y1)
+{
+    frontier.clear();
+    constraints.clear();
+
+    constraint_t constraint{};
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            const size_t i = board.index(x, y);
+            if (!board.is_revealed(i) || board.mines_around(i) == 0) continue;
+
+            solver.get_constraint(board, i, constraint);
+            if (constraint.count == 0) continue;
+
+            // Cell indices for now, turned into frontier ids once the frontier is sorted
+            frontier_constraint_t entry{};
+            entry.count = constraint.count;
+            entry.mines = constraint.mines;
+            for (int k = 0; k < constraint.count; ++k)
+            {
+                entry.vars[k] = constraint.cells[k];
+                frontier.push_back(constraint.cells[k]);
+            }
+            constraints.push_back(entry);
+        }
+    }
+
+    std::sort(frontier.begin(), frontier.end());
+    frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
+
+    for (frontier_constraint_t& entry : constraints)
+    {
+        for (int k = 0; k < entry.count; ++k)
+        {
+            entry.vars[k] = static_cast<uint32_t>(
+                std::lower_bound(frontier.begin(), frontier.end(), entry.vars[k]) - frontier.begin());
+        }
+    }
+
+    frontier_prob.assign(frontier.size(), 0.0f);
+}
+
+void ProbabilityEngine::split_components()
+{
+    std::vector<uint32_t> parent(frontier.size());
+    for (uint32_t v = 0; v < parent.size(); ++v) parent[v] = v;
+
+    for (const frontier_constraint_t& entry : constraints)
+    {
+        const uint32_t root = find_root(parent, entry.vars[0]);
+        for (int k = 1; k < entry.count; ++k)
+        {
+            parent[find_root(parent, entry.vars[k])] = root;
+        }
+    }
+
+    // Component per root, numbered in frontier order so results do not depend on timing
+    std::vector<uint32_t> component_of(frontier.size(), UINT32_MAX);
+    components.clear();
+    for (uint32_t v = 0; v < frontier.size(); ++v)
+    {
+        const uint32_t root = find_root(parent, v);
+        if (component_of[root] == UINT32_MAX)
+        {
+            component_of[root] = static_cast<uint32_t>(components.size());
+            components.push_back({});
+        }
+        components[component_of[root]].vars.push_back(v);
+    }
+
+    for (uint32_t c = 0; c < constraints.size(); ++c)
+    {
+        components[component_of[find_root(parent, constraints[c].vars[0])]].constraints.push_back(c);
+    }
+
+    // Frontier cells beyond the exact budget keep their local estimate, decided before
+    // enumerating so no backtracking is spent on components that would be thrown away.
+    // Oversized components are approximated by enumerate and do not count.
+    size_t exact_cells = 0;
+    for (component_t& component : components)
+    {
+        if (component.vars.size() > MAX_COMPONENT_CELLS) continue;
+
+        exact_cells += component.vars.size();
+        if (exact_cells > MAX_EXACT_FRONTIER) approximate(component);
+    }
+}
+
+void ProbabilityEngine::enumerate(component_t& component) const
+{
+    TRACE_ZONE("enumerate_component");
+
+    const size_t n = component.vars.size();
+    component.nodes = 0;
+
+    // The per cell tables grow with the square of the size, such components never finish anyway
+    if (n > MAX_COMPONENT_CELLS)
+    {
+        approximate(component);
+        return;
+    }
+
+    component.weights.assign(n + 1, 0.0);
+    component.var_weights.assign(n * (n + 1), 0.0);
+    component.approximate = false;
+    component.fixed_mines = 0;
+
+    // Frontier id to local id, vars are sorted so a search is enough
+    const auto local = [&component](const uint32_t v) {
+        return static_cast<uint32_t>(
+            std::lower_bound(component.vars.begin(), component.vars.end(), v) - component.vars.begin());
+    };
+
+    enumerator_t e{};
+    e.n = n;
+    e.cell_constraints.assign(n * 8, 0);
+    e.cell_constraint_count.assign(n, 0);
+    e.target.resize(component.constraints.size());
+    e.placed.assign(component.constraints.size(), 0);
+    e.open.resize(component.constraints.size());
+    e.assigned.assign(n, 0);
+    e.max_mines = n;
+    e.cap = work_cap;
+    e.weights = component.weights.data();
+    e.var_weights = component.var_weights.data();
+
+    for (size_t c = 0; c < component.constraints.size(); ++c)
+    {
+        const frontier_constraint_t& entry = constraints[component.constraints[c]];
+        e.target[c] = entry.mines;
+        e.open[c] = entry.count;
+        for (int k = 0; k < entry.count; ++k)
+        {
+            const uint32_t v = local(entry.vars[k]);
+            e.cell_constraints[static_cast<size_t>(v) * 8 + e.cell_constraint_count[v]++] = static_cast<uint32_t>(c);
+        }
+    }
+
+    // Breadth first over shared constraints, so each constraint is decided soon after its first cell
+    std::vector<uint8_t> seen(n, 0);
+    std::vector<uint8_t> seen_constraint(component.constraints.size(), 0);
+    e.order.reserve(n);
+    for (uint32_t root = 0; root < n; ++root)
+    {
+        if (seen[root]) continue;
+        seen[root] = 1;
+        e.order.push_back(root);
+
+        for (size_t head = e.order.size() - 1; head < e.order.size(); ++head)
+        {
+            const uint32_t v = e.order[head];
+            for (int k = 0; k < e.cell_constraint_count[v]; ++k)
+            {
+                const uint32_t c = e.cell_constraints[static_cast<size_t>(v) * 8 + k];
+                if (seen_constraint[c]) continue;
+                seen_constraint[c] = 1;
+
+                const frontier_constraint_t& entry = constraints[component.constraints[c]];
+                for (int j = 0; j < entry.count; ++j)
+                {
+                    const uint32_t u = local(entry.vars[j]);
+                    if (!seen[u])
+                    {
+                        seen[u] = 1;
+                        e.order.push_back(u);
+                    }
+                }
+            }
+        }
+    }
+
+    e.run(0);
+    component.nodes = e.nodes;
+
+    double total = 0.0;
+    for (const double w : component.weights) total += w;
+
+    if (e.aborted || total <= 0.0)
+    {
+        approximate(component);
+        return;
+    }
+
+    // Common scale for both, the combination only uses ratios within a component
+    double top = 0.0;
+    for (const double w : component.weights) top = std::max(top, w);
+    for (double& w : component.weights) w /= top;
+    for (double& w : component.var_weights) w /= top;
+}
+
+void ProbabilityEngine::approximate(component_t& component) const
+{
+    component.approximate = true;
+    component.weights.clear();
+    component.var_weights.clear();
+
+    // Each cell takes the mean density of the numbers around it
+    std::vector<double> sum(component.vars.size(), 0.0);
+    std::vector<int> count(component.vars.size(), 0);
+    for (const uint32_t c : component.constraints)
+    {
+        const frontier_constraint_t& entry = constraints[c];
+        const double density = static_cast<double>(entry.mines) / static_cast<double>(entry.count);
+        for (int k = 0; k < entry.count; ++k)
+        {
+            const size_t v = static_cast<size_t>(
+                std::lower_bound(component.vars.begin(), component.vars.end(), entry.vars[k]) -
+                component.vars.begin());
+            sum[v] += density;
+            ++count[v];
+        }
+    }
+
+    double expected = 0.0;
+    for (size_t v = 0; v < sum.size(); ++v)
+    {
+        sum[v] = count[v] > 0 ? sum[v] / count[v] : 0.0;
+        expected += sum[v];
+    }
+    component.fixed_mines = static_cast<int>(std::lround(expected));
+
+    // Stored as a one row weight table so combine treats both kinds alike
+    component.var_weights = std::move(sum);
+}
+
+void ProbabilityEngine::combine(const size_t mines_left, const size_t other_cells)
+{
+    TRACE_ZONE("combine");
+
+    std::vector<component_t*> exact_components;
+    size_t fixed = 0;
+    size_t frontier_total = 0;
+    for (component_t& component : components)
+    {
+        if (component.approximate)
+        {
+            fixed += static_cast<size_t>(component.fixed_mines);
+            for (size_t v = 0; v < component.vars.size(); ++v)
+            {
+                frontier_prob[component.vars[v]] = static_cast<float>(component.var_weights[v]);
+            }
+        }
+        else
+        {
+            exact_components.push_back(&component);
+            frontier_total += component.vars.size();
+        }
+    }
+
+    const size_t mines = mines_left > fixed ? mines_left - fixed : 0;
+
+    // ways[t]: arrangements of the unconstrained cells when the exact frontier holds t mines
+    std::vector<double> ways(frontier_total + 1, 0.0);
+    {
+        double top = -HUGE_VAL;
+        std::vector<double> logs(frontier_total + 1, -HUGE_VAL);
+        for (size_t t = 0; t <= frontier_total && t <= mines; ++t)
+        {
+            if (mines - t > other_cells) continue;
+            logs[t] = log_choose(other_cells, mines - t);
+            top = std::max(top, logs[t]);
+        }
+        for (size_t t = 0; t <= frontier_total; ++t)
+        {
+            if (logs[t] > -HUGE_VAL) ways[t] = std::exp(logs[t] - top);
+        }
+    }
+
+    // before[c]: most mines the components ahead of c can hold
+    const size_t count = exact_components.size();
+    std::vector<size_t> before(count + 1, 0);
+    for (size_t c = 0; c < count; ++c) before[c + 1] = before[c] + exact_components[c]->vars.size();
+
+    // suffix[c][t]: weight of everything from c on when the components ahead of it hold t mines
+    std::vector<std::vector<double>> suffix(count + 1);
+    suffix[count] = ways;
+    for (size_t c = count; c-- > 0;)
+    {
+        const std::vector<double>& w = exact_components[c]->weights;
+        const std::vector<double>& next = suffix[c + 1];
+        std::vector<double>& out = suffix[c];
+        out.assign(before[c] + 1, 0.0);
+
+        for (size_t t = 0; t <= before[c]; ++t)
+        {
+            double sum = 0.0;
+            for (size_t k = 0; k < w.size(); ++k) sum += w[k] * next[t + k];
+            out[t] = sum;
+        }
+        normalise(out);
+    }
+
+    // prefix: mine count distribution of the components handled so far
+    std::vector<double> prefix{1.0};
+    std::vector<double> outer;
+    for (size_t c = 0; c < count; ++c)
+    {
+        component_t& component = *exact_components[c];
+        const size_t n = component.vars.size();
+        const std::vector<double>& next = suffix[c + 1];
+
+        // outer[k]: weight of everything else when this component holds k mines
+        outer.assign(n + 1, 0.0);
+        for (size_t k = 0; k <= n; ++k)
+        {
+            double sum = 0.0;
+            for (size_t j = 0; j < prefix.size(); ++j) sum += prefix[j] * next[k + j];
+            outer[k] = sum;
+        }
+
+        double z = 0.0;
+        for (size_t k = 0; k <= n; ++k) z += component.weights[k] * outer[k];
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            double sum = 0.0;
+            for (size_t k = 0; k <= n; ++k) sum += component.var_weights[v * (n + 1) + k] * outer[k];
+            frontier_prob[component.vars[v]] = z > 0.0 ? static_cast<float>(sum / z) : 0.0f;
+        }
+
+        std::vector<double> grown(prefix.size() + n, 0.0);
+        for (size_t j = 0; j < prefix.size(); ++j)
+        {
+            for (size_t k = 0; k <= n; ++k) grown[j + k] += prefix[j] * component.weights[k];
+        }
+        normalise(grown);
+        prefix = std::move(grown);
+    }
+
+    // Unconstrained cells split the mines the frontier leaves over evenly
+    other_prob = 0.0f;
+    if (other_cells > 0)
+    {
+        double z = 0.0;
+        double expected = 0.0;
+        for (size_t t = 0; t < prefix.size() && t <= frontier_total; ++t)
+        {
+            const double w = prefix[t] * ways[t];
+            z += w;
+            if (t <= mines) expected += w * static_cast<double>(mines - t);
+        }
+        if (z > 0.0) other_prob = static_cast<float>(expected / z / static_cast<double>(other_cells));
+    }
+}
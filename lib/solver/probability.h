@@ -0,0 +1,124 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef PROBABILITY_H
+#define PROBABILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+#include "solver.h"
+
+class ThreadPool;
+
+// Exact mine probability for every closed cell, from the player's point of
+// view. Closed cells next to revealed numbers (the frontier) are split into
+// independent components that are enumerated on their own, in parallel, and
+// combined with the cells no number touches through binomial weighting:
+// a frontier total of t mines leaves C(other cells, mines left - t) ways for
+// the rest of the board.
+//
+// Components past the work cap fall back to each cell's local mine density,
+// the result then reports itself as approximate.
+
+typedef struct PROBABILITY_STATS
+{
+    size_t frontier_cells;
+    size_t constraints;
+    size_t components;
+    size_t approximate_components;
+    // Backtracking nodes visited over all components
+    uint64_t nodes;
+    double ms;
+} probability_stats_t;
+
+class ProbabilityEngine
+{
+    // Revealed number with its closed cells as frontier ids
+    typedef struct FRONTIER_CONSTRAINT
+    {
+        uint32_t vars[8];
+        int count;
+        int mines;
+    } frontier_constraint_t;
+
+    typedef struct COMPONENT
+    {
+        std::vector<uint32_t> vars;
+        std::vector<uint32_t> constraints;
+        // Solutions by number of mines in the component, scaled so the largest is 1
+        std::vector<double> weights;
+        // vars.size() rows of weights, counting only solutions where that cell is a mine
+        std::vector<double> var_weights;
+        uint64_t nodes;
+        bool approximate;
+        // Mines an approximate component is assumed to hold
+        int fixed_mines;
+    } component_t;
+
+    ThreadPool* pool;
+    uint64_t work_cap{1u << 20};
+
+    // Sorted cell indices of the frontier, frontier_prob runs parallel to it
+    std::vector<uint32_t> frontier;
+    std::vector<float> frontier_prob;
+    std::vector<frontier_constraint_t> constraints;
+    std::vector<component_t> components;
+
+    // Every closed cell no number touches shares this probability
+    float other_prob{0.0f};
+    bool exact{false};
+
+    probability_stats_t stats{};
+
+    // Boards up to this many cells are always analysed whole
+    static constexpr size_t FULL_SCAN_CELLS{1u << 22};
+    // Frontier cells combined exactly, time and memory of the combination are quadratic in this
+    static constexpr size_t MAX_EXACT_FRONTIER{2048};
+    // Larger components go straight to the approximation
+    static constexpr size_t MAX_COMPONENT_CELLS{512};
+
+public:
+    explicit ProbabilityEngine(ThreadPool* _pool) : pool{_pool}
+    {
+    };
+
+    ~ProbabilityEngine() = default;
+
+public:
+    // Backtracking nodes one component may visit before it falls back to the approximation
+    void set_work_cap(uint64_t _work_cap);
+
+    // Recomputes every probability. Boards past FULL_SCAN_CELLS only use the numbers
+    // inside [x0, x1] x [y0, y1], which makes the result approximate.
+    void compute(const Board& board, const Solver& solver, int x0, int y0, int x1, int y1);
+
+    // Mine probability of cell i as of the last compute, -1 for revealed cells
+    [[nodiscard]] float probability(const Board& board, const Solver& solver, size_t i) const;
+
+    // Closed cell with the lowest mine probability inside [x0, x1] x [y0, y1], false if none is closed
+    bool safest_cell(const Board& board, const Solver& solver, int x0, int y0, int x1, int y1,
+                     int& x, int& y) const;
+
+    [[nodiscard]] bool is_exact(void) const;
+
+    [[nodiscard]] const probability_stats_t& get_stats(void) const;
+
+private:
+    void collect_frontier(const Board& board, const Solver& solver, int x0, int y0, int x1, int y1);
+
+    // Also marks the components past the exact frontier budget approximate
+    void split_components(void);
+
+    void enumerate(component_t& component) const;
+
+    void approximate(component_t& component) const;
+
+    // Binomial weighting of the component totals against the unconstrained cells
+    void combine(size_t mines_left, size_t other_cells);
+};
+
+#endif //PROBABILITY_H
@@ -0,0 +1,348 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "trace.h"
+
+static bool contains(const constraint_t& set, const uint32_t cell)
+{
+    for (int k = 0; k < set.count; ++k)
+    {
+        if (set.cells[k] == cell) return true;
+    }
+    return false;
+}
+
+static bool is_subset(const constraint_t& inner, const constraint_t& outer)
+{
+    if (inner.count > outer.count) return false;
+
+    for (int k = 0; k < inner.count; ++k)
+    {
+        if (!contains(outer, inner.cells[k])) return false;
+    }
+    return true;
+}
+
+void Solver::reset(const int _cols, const int _rows)
+{
+    cols = _cols > 0 ? _cols : 0;
+    rows = _rows > 0 ? _rows : 0;
+
+    const size_t words = (static_cast<size_t>(cols) * static_cast<size_t>(rows) + 63) / 64;
+    safe_bits.assign(words, 0);
+    mine_bits.assign(words, 0);
+    queued_bits.assign(words, 0);
+
+    queue.clear();
+    safe_moves.clear();
+    scan_pos = 0;
+    scan_end = 0;
+    known_safe = 0;
+    known_mines = 0;
+}
+
+void Solver::note_dirty(const Board& board)
+{
+    if (board.get_cols() != cols || board.get_rows() != rows) return;
+
+    if (board.is_dirty_overflow())
+    {
+        size_t lo = 0;
+        size_t hi = 0;
+        if (!board.get_dirty_range(lo, hi)) return;
+
+        // Too many changes to list, walk their index range a chunk per step instead
+        scan_pos = scan_pos < scan_end ? std::min(scan_pos, lo) : lo;
+        scan_end = std::max(scan_end, hi + 1);
+        return;
+    }
+
+    for (const uint32_t i : board.get_dirty())
+    {
+        if (board.is_revealed(i)) enqueue_around(board, i);
+    }
+}
+
+bool Solver::step(const Board& board, const uint32_t budget_us)
+{
+    if (!is_pending()) return false;
+
+    // Cells revealed on a lost board carry no information for the player
+    if (board.get_state() == board_state::LOST)
+    {
+        queue.clear();
+        scan_pos = scan_end;
+        return false;
+    }
+
+    TRACE_ZONE("solver_step");
+
+    constexpr size_t cells_per_check = 4096;
+    constexpr size_t examines_per_check = 256;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(budget_us);
+
+    while (scan_pos < scan_end)
+    {
+        const size_t end = std::min(scan_end, scan_pos + cells_per_check);
+        for (; scan_pos < end; ++scan_pos)
+        {
+            if (board.is_revealed(scan_pos)) enqueue(board, scan_pos);
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) return is_pending();
+    }
+
+    size_t examined = 0;
+    while (!queue.empty())
+    {
+        const size_t i = queue.back();
+        queue.pop_back();
+        clear_bit(queued_bits, i);
+
+        examine(board, i);
+
+        if (++examined >= examines_per_check)
+        {
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            examined = 0;
+        }
+    }
+
+    return is_pending();
+}
+
+void Solver::drain(const Board& board)
+{
+    if (board.get_state() == board_state::LOST)
+    {
+        queue.clear();
+        scan_pos = scan_end;
+        return;
+    }
+
+    for (; scan_pos < scan_end; ++scan_pos)
+    {
+        if (board.is_revealed(scan_pos)) enqueue(board, scan_pos);
+    }
+
+    while (!queue.empty())
+    {
+        const size_t i = queue.back();
+        queue.pop_back();
+        clear_bit(queued_bits, i);
+
+        examine(board, i);
+    }
+}
+
+bool Solver::is_pending() const
+{
+    return scan_pos < scan_end || !queue.empty();
+}
+
+bool Solver::next_safe_move(const Board& board, int& x, int& y)
+{
+    // Stale entries are dropped here instead of on every reveal
+    while (!safe_moves.empty() && board.is_revealed(safe_moves.back()))
+    {
+        safe_moves.pop_back();
+    }
+
+    // A safe cell the player flagged cannot be opened, it stays queued for when the flag comes off
+    for (size_t k = safe_moves.size(); k-- > 0;)
+    {
+        const size_t i = safe_moves[k];
+        if (board.is_revealed(i) || board.is_flagged(i)) continue;
+
+        x = static_cast<int>(i % static_cast<size_t>(cols));
+        y = static_cast<int>(i / static_cast<size_t>(cols));
+        return true;
+    }
+
+    return false;
+}
+
+void Solver::get_constraint(const Board& board, const size_t i, constraint_t& out) const
+{
+    out.count = 0;
+    out.mines = static_cast<int>(board.mines_around(i));
+
+    const int x = static_cast<int>(i % static_cast<size_t>(cols));
+    const int y = static_cast<int>(i / static_cast<size_t>(cols));
+
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            if ((dx == 0 && dy == 0) || !board.in_bounds(x + dx, y + dy)) continue;
+
+            const size_t n = board.index(x + dx, y + dy);
+            if (board.is_revealed(n) || is_known_safe(n)) continue;
+
+            if (is_known_mine(n))
+            {
+                --out.mines;
+            }
+            else
+            {
+                out.cells[out.count++] = static_cast<uint32_t>(n);
+            }
+        }
+    }
+}
+
+size_t Solver::get_known_safe() const
+{
+    return known_safe;
+}
+
+size_t Solver::get_known_mines() const
+{
+    return known_mines;
+}
+
+size_t Solver::count_closed_safe(const Board& board) const
+{
+    // Every deduced safe cell is listed once, opened ones are only dropped lazily
+    size_t count = 0;
+    for (const uint32_t i : safe_moves)
+    {
+        if (!board.is_revealed(i)) ++count;
+    }
+    return count;
+}
+
+size_t Solver::memory_usage() const
+{
+    return (safe_bits.capacity() + mine_bits.capacity() + queued_bits.capacity()) * sizeof(uint64_t) +
+        (queue.capacity() + safe_moves.capacity()) * sizeof(uint32_t);
+}
+
+void Solver::enqueue(const Board& board, const size_t i)
+{
+    // Zeros are opened by the board's own flood fill, they never add anything
+    if (!board.is_revealed(i) || board.mines_around(i) == 0 || test_bit(queued_bits, i)) return;
+
+    set_bit(queued_bits, i);
+    queue.push_back(static_cast<uint32_t>(i));
+}
+
+void Solver::enqueue_around(const Board& board, const size_t i)
+{
+    const int x = static_cast<int>(i % static_cast<size_t>(cols));
+    const int y = static_cast<int>(i / static_cast<size_t>(cols));
+
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            if (board.in_bounds(x + dx, y + dy)) enqueue(board, board.index(x + dx, y + dy));
+        }
+    }
+}
+
+bool Solver::mark(const Board& board, const size_t i, const bool is_mine)
+{
+    if (is_known_safe(i) || is_known_mine(i)) return false;
+
+    if (is_mine)
+    {
+        set_bit(mine_bits, i);
+        ++known_mines;
+    }
+    else
+    {
+        set_bit(safe_bits, i);
+        ++known_safe;
+        safe_moves.push_back(static_cast<uint32_t>(i));
+    }
+
+    // Every number around the cell just lost a closed cell
+    enqueue_around(board, i);
+    return true;
+}
+
+int Solver::mark_difference(const Board& board, const constraint_t& cells, const constraint_t& skip,
+                            const bool is_mine)
+{
+    int marked = 0;
+    for (int k = 0; k < cells.count; ++k)
+    {
+        if (!contains(skip, cells.cells[k]) && mark(board, cells.cells[k], is_mine)) ++marked;
+    }
+    return marked;
+}
+
+void Solver::examine(const Board& board, const size_t i)
+{
+    constraint_t own{};
+    get_constraint(board, i, own);
+    if (own.count == 0) return;
+
+    constexpr constraint_t none{{}, 0, 0};
+
+    // Single point: every closed cell is safe, or every closed cell is a mine
+    if (own.mines == 0 || own.mines == own.count)
+    {
+        mark_difference(board, own, none, own.mines != 0);
+        return;
+    }
+
+    // Subset: only numbers within two cells can share closed cells with this one
+    const int x = static_cast<int>(i % static_cast<size_t>(cols));
+    const int y = static_cast<int>(i / static_cast<size_t>(cols));
+
+    constraint_t other{};
+    for (int dy = -2; dy <= 2; ++dy)
+    {
+        for (int dx = -2; dx <= 2; ++dx)
+        {
+            if ((dx == 0 && dy == 0) || !board.in_bounds(x + dx, y + dy)) continue;
+
+            const size_t n = board.index(x + dx, y + dy);
+            if (!board.is_revealed(n) || board.mines_around(n) == 0) continue;
+
+            // Cheaper than building the other constraint: it needs one of our cells next to it
+            bool shares = false;
+            for (int k = 0; k < own.count && !shares; ++k)
+            {
+                const int cx = static_cast<int>(own.cells[k] % static_cast<uint32_t>(cols));
+                const int cy = static_cast<int>(own.cells[k] / static_cast<uint32_t>(cols));
+                shares = std::abs(cx - (x + dx)) <= 1 && std::abs(cy - (y + dy)) <= 1;
+            }
+            if (!shares) continue;
+
+            get_constraint(board, n, other);
+            if (other.count == 0) continue;
+
+            int marked = 0;
+            if (own.count < other.count && is_subset(own, other))
+            {
+                const int left = other.mines - own.mines;
+                const int diff = other.count - own.count;
+                if (left == 0 || left == diff) marked = mark_difference(board, other, own, left != 0);
+            }
+            else if (other.count < own.count && is_subset(other, own))
+            {
+                const int left = own.mines - other.mines;
+                const int diff = own.count - other.count;
+                if (left == 0 || left == diff) marked = mark_difference(board, own, other, left != 0);
+            }
+
+            // Our own set may be stale now, look at this cell again with fresh deductions
+            if (marked > 0)
+            {
+                enqueue(board, i);
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+// SDL-free deduction engine over what the player can see: revealed numbers
+// only, never the mine plane. Revealed cells are fed in from the board's
+// dirty list and only their neighbourhood gets re-examined, so the cost of
+// a click is proportional to the cells it changed, not to the board.
+//
+// Deductions are single point (a number whose mines are all accounted for,
+// or whose closed cells must all be mines) and subset (one number's closed
+// cells contained in a neighbour's, the difference holds the remainder).
+
+// Closed cells around a revealed number that are not yet deduced, with the mines left among them
+typedef struct CONSTRAINT
+{
+    uint32_t cells[8];
+    int count;
+    int mines;
+} constraint_t;
+
+class Solver
+{
+    std::vector<uint64_t> safe_bits;
+    std::vector<uint64_t> mine_bits;
+    // Revealed cells waiting in `queue`, so each is queued at most once
+    std::vector<uint64_t> queued_bits;
+
+    // Revealed numbers whose closed neighbourhood changed since they were last examined
+    std::vector<uint32_t> queue;
+    // Deduced safe cells, entries the player opened in the meantime are skipped on query
+    std::vector<uint32_t> safe_moves;
+
+    // Index range still to rescan after the board's dirty list overflowed
+    size_t scan_pos{0};
+    size_t scan_end{0};
+
+    int cols{0};
+    int rows{0};
+
+    size_t known_safe{0};
+    size_t known_mines{0};
+
+public:
+    Solver() = default;
+
+    ~Solver() = default;
+
+public:
+    // Forgets every deduction, call whenever the board is initialised
+    void reset(int _cols, int _rows);
+
+    // Queues the cells the board reports changed, call before Board::clear_dirty
+    void note_dirty(const Board& board);
+
+    // Examines queued cells for at most budget_us microseconds.
+    // Returns true while part of the work is still pending.
+    bool step(const Board& board, uint32_t budget_us);
+
+    // Runs all pending work without reading the clock, for headless callers
+    void drain(const Board& board);
+
+    [[nodiscard]] bool is_pending(void) const;
+
+    // Most recently deduced safe cell that is still closed and unflagged, false when none is known yet
+    bool next_safe_move(const Board& board, int& x, int& y);
+
+    // Builds the constraint of revealed cell i from the board and current deductions
+    void get_constraint(const Board& board, size_t i, constraint_t& out) const;
+
+public:
+    [[nodiscard]] bool is_known_safe(const size_t i) const { return test_bit(safe_bits, i); }
+
+    [[nodiscard]] bool is_known_mine(const size_t i) const { return test_bit(mine_bits, i); }
+
+    [[nodiscard]] size_t get_known_safe(void) const;
+
+    [[nodiscard]] size_t get_known_mines(void) const;
+
+    // Deduced safe cells the player has not opened yet
+    [[nodiscard]] size_t count_closed_safe(const Board& board) const;
+
+    [[nodiscard]] size_t memory_usage(void) const;
+
+private:
+    static bool test_bit(const std::vector<uint64_t>& plane, const size_t i)
+    {
+        return (plane[i >> 6] >> (i & 63)) & 1u;
+    }
+
+    static void set_bit(std::vector<uint64_t>& plane, const size_t i)
+    {
+        plane[i >> 6] |= uint64_t{1} << (i & 63);
+    }
+
+    static void clear_bit(std::vector<uint64_t>& plane, const size_t i)
+    {
+        plane[i >> 6] &= ~(uint64_t{1} << (i & 63));
+    }
+
+    void enqueue(const Board& board, size_t i);
+
+    // Queues the revealed cell i together with its revealed neighbours
+    void enqueue_around(const Board& board, size_t i);
+
+    // Records a deduction, false when the cell was already known
+    bool mark(const Board& board, size_t i, bool is_mine);
+
+    // Marks every cell of `cells` outside `skip`, returns the number of new deductions
+    int mark_difference(const Board& board, const constraint_t& cells, const constraint_t& skip, bool is_mine);
+
+    void examine(const Board& board, size_t i);
+};
+
+#endif //SOLVER_H
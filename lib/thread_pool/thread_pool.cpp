@@ -0,0 +1,109 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "thread_pool.h"
+
+#include "trace.h"
+
+ThreadPool::ThreadPool(unsigned int threads)
+{
+    if (threads == 0)
+    {
+        const unsigned int hardware = std::thread::hardware_concurrency();
+        threads = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    workers.reserve(threads);
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(const size_t count, const std::function<void(size_t)>& fn)
+{
+    if (count == 0) return;
+
+    // Not worth waking anyone for a single item
+    if (workers.empty() || count == 1)
+    {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        job = &fn;
+        job_count = count;
+        next_index.store(0, std::memory_order_relaxed);
+        busy = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+
+    run_indices(fn, count);
+
+    // Every index is claimed by now, wait for the workers to finish theirs and let go of `fn`
+    std::unique_lock<std::mutex> guard{lock};
+    done.wait(guard, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+unsigned int ThreadPool::get_thread_count() const
+{
+    return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+void ThreadPool::worker_loop()
+{
+    trace::set_thread_name("pool worker");
+
+    uint64_t seen = 0;
+    while (true)
+    {
+        const std::function<void(size_t)>* fn = nullptr;
+        size_t count = 0;
+        {
+            std::unique_lock<std::mutex> guard{lock};
+            wake.wait(guard, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+
+            seen = generation;
+            fn = job;
+            count = job_count;
+        }
+
+        run_indices(*fn, count);
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> guard{lock};
+            last = --busy == 0;
+        }
+        if (last) done.notify_one();
+    }
+}
+
+void ThreadPool::run_indices(const std::function<void(size_t)>& fn, const size_t count)
+{
+    for (size_t i = next_index.fetch_add(1, std::memory_order_relaxed); i < count;
+         i = next_index.fetch_add(1, std::memory_order_relaxed))
+    {
+        fn(i);
+    }
+}
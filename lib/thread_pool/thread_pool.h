@@ -0,0 +1,63 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork / join loops. parallel_for hands out
+// indices through an atomic counter and the calling thread works along, so
+// a pool with zero workers simply runs the loop inline.
+
+class ThreadPool
+{
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // Current loop, picked up by the workers under `lock` when `generation` moves
+    const std::function<void(size_t)>* job{nullptr};
+    size_t job_count{0};
+    uint64_t generation{0};
+    std::atomic<size_t> next_index{0};
+    // Workers still inside the current loop
+    size_t busy{0};
+
+    bool stopping{false};
+
+public:
+    // 0 uses one worker less than the hardware threads, the caller makes up the last one
+    explicit ThreadPool(unsigned int threads = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+    // Runs fn(i) for every i in [0, count) across the pool and returns once all of them finished.
+    // Not reentrant, one loop at a time per pool.
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+    // Workers plus the calling thread
+    [[nodiscard]] unsigned int get_thread_count(void) const;
+
+private:
+    void worker_loop(void);
+
+    void run_indices(const std::function<void(size_t)>& fn, size_t count);
+};
+
+#endif //THREAD_POOL_H
@@ -0,0 +1,151 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trace
+{
+    std::atomic<bool> enabled{false};
+
+    typedef struct THREAD_BUFFER
+    {
+        std::vector<event_t> events;
+        size_t dropped;
+        uint32_t tid;
+        const char* name;
+    } thread_buffer_t;
+
+    // Buffers outlive their threads through the registry, the lock is only taken once per thread
+    static std::mutex registry_lock;
+    static std::vector<std::shared_ptr<thread_buffer_t>> registry;
+    static uint32_t next_tid{1};
+    static std::string output_path;
+
+    static const auto epoch = std::chrono::steady_clock::now();
+
+    // Created by the first recorded zone, so threads that never record while capturing cost nothing
+    static thread_local std::shared_ptr<thread_buffer_t> buffer;
+    static thread_local const char* thread_name{nullptr};
+
+    static thread_buffer_t& local_buffer()
+    {
+        if (!buffer)
+        {
+            buffer = std::make_shared<thread_buffer_t>();
+            buffer->dropped = 0;
+            buffer->name = thread_name;
+            buffer->events.reserve(4096);
+
+            const std::lock_guard<std::mutex> guard{registry_lock};
+            buffer->tid = next_tid++;
+            registry.push_back(buffer);
+        }
+
+        return *buffer;
+    }
+
+    // Zone names are literals, escape anyway so a stray quote cannot break the file
+    static void write_string(std::FILE* file, const char* text)
+    {
+        std::fputc('"', file);
+        for (const char* c = text ? text : ""; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\') std::fputc('\\', file);
+            if (static_cast<unsigned char>(*c) >= 0x20) std::fputc(*c, file);
+        }
+        std::fputc('"', file);
+    }
+
+    void start(const char* path)
+    {
+        {
+            const std::lock_guard<std::mutex> guard{registry_lock};
+            output_path = path ? path : "";
+
+            for (const auto& buffer : registry)
+            {
+                buffer->events.clear();
+                buffer->dropped = 0;
+            }
+        }
+
+        enabled.store(!output_path.empty(), std::memory_order_relaxed);
+    }
+
+    bool stop()
+    {
+        if (!enabled.exchange(false, std::memory_order_relaxed)) return false;
+
+        const std::lock_guard<std::mutex> guard{registry_lock};
+
+        std::FILE* file = std::fopen(output_path.c_str(), "w");
+        if (!file) return false;
+
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+
+        bool first = true;
+        size_t dropped = 0;
+        for (const auto& buffer : registry)
+        {
+            if (buffer->name)
+            {
+                std::fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":",
+                             first ? "" : ",\n", buffer->tid);
+                write_string(file, buffer->name);
+                std::fputs("}}", file);
+                first = false;
+            }
+
+            for (const event_t& event : buffer->events)
+            {
+                std::fprintf(file, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                             first ? "" : ",\n", buffer->tid,
+                             static_cast<double>(event.start_ns) / 1000.0,
+                             static_cast<double>(event.duration_ns) / 1000.0);
+                write_string(file, event.name);
+                std::fputc('}', file);
+                first = false;
+            }
+
+            dropped += buffer->dropped;
+            buffer->events.clear();
+            buffer->dropped = 0;
+        }
+
+        std::fprintf(file, "\n],\"otherData\":{\"dropped_events\":%zu}}\n", dropped);
+
+        return std::fclose(file) == 0;
+    }
+
+    void set_thread_name(const char* name)
+    {
+        thread_name = name;
+        if (buffer) buffer->name = name;
+    }
+
+    uint64_t now_ns()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    void record(const char* name, const uint64_t start_ns, const uint64_t end_ns)
+    {
+        thread_buffer_t& buffer = local_buffer();
+        if (buffer.events.size() >= MAX_EVENTS_PER_THREAD)
+        {
+            ++buffer.dropped;
+            return;
+        }
+
+        buffer.events.push_back({name, start_ns, end_ns - start_ns});
+    }
+}
@@ -0,0 +1,82 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Optional capture of scoped zones as Chrome trace-event JSON, readable by
+// chrome://tracing and Perfetto. Every thread records into its own buffer
+// without locking. Compiled out without MINESWEEPER_TRACE, a single relaxed
+// load per zone while capture is off.
+
+namespace trace
+{
+    typedef struct EVENT
+    {
+        const char* name;
+        uint64_t start_ns;
+        uint64_t duration_ns;
+    } event_t;
+
+    // Zones stop recording past this many events per thread, later ones are counted as dropped
+    constexpr size_t MAX_EVENTS_PER_THREAD{1u << 20};
+
+    extern std::atomic<bool> enabled;
+
+    [[nodiscard]] inline bool is_enabled(void)
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    // Starts capturing, the file is written by stop
+    void start(const char* path);
+
+    // Stops capturing and writes every thread's events. Threads still recording must be joined first.
+    bool stop(void);
+
+    // Label for the calling thread in the trace viewer, the name must outlive the capture.
+    // Only stored until the thread records its first zone, no buffer is made for it.
+    void set_thread_name(const char* name);
+
+    [[nodiscard]] uint64_t now_ns(void);
+
+    void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+}
+
+class TraceZone
+{
+    const char* name;
+    uint64_t start_ns{0};
+    bool active;
+
+public:
+    explicit TraceZone(const char* _name) : name{_name}, active{trace::is_enabled()}
+    {
+        if (active) start_ns = trace::now_ns();
+    };
+
+    ~TraceZone()
+    {
+        if (active) trace::record(name, start_ns, trace::now_ns());
+    };
+
+    TraceZone(const TraceZone&) = delete;
+
+    TraceZone& operator=(const TraceZone&) = delete;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#if defined(MINESWEEPER_TRACE) && MINESWEEPER_TRACE
+#define TRACE_ZONE(name) const TraceZone TRACE_CONCAT(trace_zone_, __LINE__){name}
+#else
+#define TRACE_ZONE(name) ((void)0)
+#endif
+
+#endif //TRACE_H
@@ -6,6 +6,13 @@
 #include "platform.h"
 #include "game.h"
 
+#include <algorithm>
+#include <cstdlib>
+
+#include <alloc_tracker.h>
+#include <profiler.h>
+#include <trace.h>
+
 extern platform::input::input_t input;
 
 Window::Window(const int width, const int height, const char* font_path, const char* title)
@@ -26,11 +33,9 @@ Window::Window(const int width, const int height, const char* font_path, const c
                               width, height,
                               SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
 
-    const auto fontPath = font_path;
-    font = TTF_OpenFont(fontPath, platform::font::TITLE_SIZE);
+    font = resources.get_font(font_path, platform::font::TITLE_SIZE);
     if (!font)
     {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_OpenFont('%s') failed: %s", fontPath, TTF_GetError());
         SDL_Log("BasePath: %s", SDL_GetBasePath() ? SDL_GetBasePath() : "(null)");
         return;
     }
@@ -43,7 +48,7 @@ Window::~Window()
 {
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
-    TTF_CloseFont(font);
+    resources.clear();
 
     TTF_Quit();
     SDL_Quit();
@@ -55,60 +60,228 @@ void Window::register_events(void)
     {
         input.buttons[i].changed = false;
     }
+    input.wheel = 0;
+    frame_events = 0;
 
-    while (SDL_PollEvent(&event))
+    // Nothing animates: block until input arrives or the requested deadline passes
+    const uint32_t timeout = is_minimized ? platform::window::IDLE_WAIT_MS : next_frame_ms;
+    next_frame_ms = platform::window::IDLE_WAIT_MS;
+
+    if (timeout > 0)
     {
-        if (event.type == SDL_QUIT)
+        TRACE_ZONE("wait");
+        if (SDL_WaitEventTimeout(&event, static_cast<int>(timeout)))
         {
-            is_running = false;
+            handle_event(event);
         }
+    }
+
+    TRACE_ZONE("events");
+
+    while (SDL_PollEvent(&event))
+    {
+        handle_event(event);
+    }
+}
+
+void Window::handle_event(const SDL_Event& e)
+{
+    ++frame_events;
+
+    if (e.type == SDL_QUIT)
+    {
+        is_running = false;
+    }
 
-        switch (event.type)
+    switch (e.type)
+    {
+    case SDL_WINDOWEVENT:
         {
-        // case SDL_WINDOWEVENT: {
-        //     if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-        //         SDL_GetCurrentDisplayMode(0, &window_size);
-        //         SDL_RenderClear(renderer);
-        //     }
-        //
-        //     break;
-        // }
-
-        case SDL_MOUSEMOTION:
+            if (e.window.windowID != SDL_GetWindowID(window)) break;
+
+            switch (e.window.event)
             {
-                SDL_GetMouseState(&mouse_x, &mouse_y);
+            case SDL_WINDOWEVENT_MINIMIZED:
+            case SDL_WINDOWEVENT_HIDDEN:
+                set_active_state(true, has_focus);
                 break;
+            case SDL_WINDOWEVENT_RESTORED:
+            case SDL_WINDOWEVENT_MAXIMIZED:
+            case SDL_WINDOWEVENT_SHOWN:
+                set_active_state(false, has_focus);
+                break;
+            case SDL_WINDOWEVENT_FOCUS_GAINED:
+                set_active_state(is_minimized, true);
+                break;
+            case SDL_WINDOWEVENT_FOCUS_LOST:
+                set_active_state(is_minimized, false);
+                break;
+            default: break;
             }
-        case SDL_MOUSEBUTTONDOWN:
-        case SDL_MOUSEBUTTONUP:
-            {
-                const bool is_down = (event.type == SDL_MOUSEBUTTONDOWN);
+            break;
+        }
 
-                switch (event.button.button)
-                {
-                READ_KEY(platform::input::MOUSE_LEFT, SDL_BUTTON_LEFT);
-                READ_KEY(platform::input::MOUSE_RIGHT, SDL_BUTTON_RIGHT);
-                default: break;
-                }
+    // case SDL_WINDOWEVENT: {
+    //     if (e.window.event == SDL_WINDOWEVENT_RESIZED) {
+    //         SDL_GetCurrentDisplayMode(0, &window_size);
+    //         SDL_RenderClear(renderer);
+    //     }
+    //
+    //     break;
+    // }
+
+    case SDL_RENDER_TARGETS_RESET:
+    case SDL_RENDER_DEVICE_RESET:
+        {
+            render_reset = true;
+            break;
+        }
+
+    case SDL_MOUSEMOTION:
+        {
+            SDL_GetMouseState(&mouse_x, &mouse_y);
+            break;
+        }
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        {
+            const bool is_down = (e.type == SDL_MOUSEBUTTONDOWN);
+
+            switch (e.button.button)
+            {
+            READ_KEY(platform::input::MOUSE_LEFT, SDL_BUTTON_LEFT);
+            READ_KEY(platform::input::MOUSE_RIGHT, SDL_BUTTON_RIGHT);
+            READ_KEY(platform::input::MOUSE_MIDDLE, SDL_BUTTON_MIDDLE);
+            default: break;
             }
+            break;
+        }
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        {
+            // Held keys are read from is_down, repeats would only fake a new press
+            if (e.key.repeat) break;
 
-        default: break;
+            const bool is_down = (e.type == SDL_KEYDOWN);
+
+            switch (e.key.keysym.sym)
+            {
+            READ_KEY(platform::input::UP, SDLK_UP);
+            READ_KEY(platform::input::DOWN, SDLK_DOWN);
+            READ_KEY(platform::input::LEFT, SDLK_LEFT);
+            READ_KEY(platform::input::RIGHT, SDLK_RIGHT);
+            READ_KEY(platform::input::W, SDLK_w);
+            READ_KEY(platform::input::S, SDLK_s);
+            READ_KEY(platform::input::A, SDLK_a);
+            READ_KEY(platform::input::D, SDLK_d);
+            READ_KEY(platform::input::M, SDLK_m);
+            READ_KEY(platform::input::F3, SDLK_F3);
+            READ_KEY(platform::input::H, SDLK_h);
+            READ_KEY(platform::input::P, SDLK_p);
+            READ_KEY(platform::input::I, SDLK_i);
+            default: break;
+            }
+            break;
         }
+    case SDL_MOUSEWHEEL:
+        {
+            input.wheel += e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -e.wheel.y : e.wheel.y;
+            break;
+        }
+
+    default: break;
     }
 }
 
-void Window::main_loop(const std::vector<func_t>& functions)
+void Window::set_active_state(const bool _is_minimized, const bool _has_focus)
 {
+    const bool was_active = is_active();
+
+    is_minimized = _is_minimized;
+    has_focus = _has_focus;
+
+    if (was_active && !is_active())
+    {
+        inactive_since = SDL_GetTicks();
+    }
+    else if (!was_active && is_active())
+    {
+        inactive_total += SDL_GetTicks() - inactive_since;
+    }
+}
+
+void Window::main_loop(const std::vector<stage_t>& stages)
+{
+    Profiler& profiler = Profiler::get();
+
+    std::vector<int> stage_ids;
+    stage_ids.reserve(stages.size());
+    for (const auto& stage : stages)
+    {
+        stage_ids.push_back(profiler.series_id(stage.name));
+    }
+    const int present_id = profiler.series_id("present");
+
+    // Caches fill and buffers reach their working size over the first frames
+    constexpr uint32_t warm_up_frames{120};
+    uint32_t frame_index{0};
+
     while (is_running)
     {
         register_events();
 
-        for (const auto& func : functions)
+        // Nothing to show while minimised, register_events keeps the loop at IDLE_WAIT_MS
+        if (is_minimized) continue;
+
+        // Idle waiting happens above, a frame only counts the work
+        profiler.begin_frame();
+        const uint64_t frame_allocs = alloc_tracker::get_count();
+
         {
-            func();
+            TRACE_ZONE("frame");
+
+            for (size_t i = 0; i < stages.size(); ++i)
+            {
+                const uint64_t stage_allocs = alloc_tracker::get_count();
+                {
+                    const ProfileScope scope{stage_ids[i]};
+                    TRACE_ZONE(stages[i].name);
+                    stages[i].func();
+                }
+                profiler.add_allocs(stage_ids[i], alloc_tracker::get_count() - stage_allocs);
+            }
+
+            const uint64_t present_allocs = alloc_tracker::get_count();
+            {
+                const ProfileScope scope{present_id};
+                TRACE_ZONE("present");
+                SDL_RenderPresent(get_renderer());
+            }
+            profiler.add_allocs(present_id, alloc_tracker::get_count() - present_allocs);
         }
 
-        SDL_RenderPresent(get_renderer());
+        const uint64_t allocs = alloc_tracker::get_count() - frame_allocs;
+        profiler.add_allocs(Profiler::FRAME, allocs);
+        profiler.end_frame();
+
+        if (frame_index < warm_up_frames)
+        {
+            ++frame_index;
+        }
+        else if (assert_no_alloc && allocs > 0 && frame_events == 0)
+        {
+            for (const auto& series : profiler.get_series())
+            {
+                if (series.allocs > 0)
+                {
+                    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "  %s: %llu allocations", series.name,
+                                    static_cast<unsigned long long>(series.allocs));
+                }
+            }
+            SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Steady state frame allocated %llu times",
+                            static_cast<unsigned long long>(allocs));
+            std::abort();
+        }
     }
 }
 
@@ -122,6 +295,16 @@ void Window::set_start_timer(const uint32_t _start_timer)
     start_timer = _start_timer;
 }
 
+void Window::set_assert_no_alloc(const bool _assert_no_alloc)
+{
+    assert_no_alloc = _assert_no_alloc;
+}
+
+void Window::request_frame(const uint32_t within_ms)
+{
+    next_frame_ms = std::min(next_frame_ms, within_ms);
+}
+
 
 SDL_Window* Window::get_window() const
 {
@@ -138,6 +321,11 @@ TTF_Font* Window::get_font() const
     return font;
 }
 
+ResourceCache* Window::get_resources()
+{
+    return &resources;
+}
+
 uint32_t Window::get_start_timer() const
 {
     return start_timer;
@@ -152,3 +340,20 @@ int Window::get_mouse_y() const
 {
     return mouse_y;
 }
+
+bool Window::is_active() const
+{
+    return has_focus && !is_minimized;
+}
+
+uint32_t Window::get_inactive_ms() const
+{
+    return is_active() ? inactive_total : inactive_total + (SDL_GetTicks() - inactive_since);
+}
+
+bool Window::consume_render_reset()
+{
+    const bool was_reset = render_reset;
+    render_reset = false;
+    return was_reset;
+}
@@ -11,15 +11,26 @@
 #include <vector>
 
 #include <platform.h>
+#include <resource_cache.h>
 
 using func_t = void(*)(void);
 
+// One step of a frame, timed by the profiler under its name
+typedef struct STAGE
+{
+    const char* name;
+    func_t func;
+} stage_t;
+
 class Window
 {
     SDL_Window* window{nullptr};
     SDL_Renderer* renderer{nullptr};
     TTF_Font* font{nullptr};
 
+    // Cursors and fonts, created once and freed before SDL shuts down
+    ResourceCache resources;
+
     SDL_DisplayMode window_size{};
     SDL_Event event{};
 
@@ -27,6 +38,20 @@ class Window
     int mouse_y{};
 
     bool is_running{true};
+    bool render_reset{false};
+    bool is_minimized{false};
+    bool has_focus{true};
+
+    // Time spent minimised or unfocused, so callers can keep it off the game clock
+    uint32_t inactive_since{0};
+    uint32_t inactive_total{0};
+
+    // Time the loop may sleep before the next frame, lowered through request_frame
+    uint32_t next_frame_ms{0};
+
+    // Events handled before the current frame, a frame without any is steady state
+    uint32_t frame_events{0};
+    bool assert_no_alloc{false};
 
     uint32_t start_timer{SDL_GetTicks()};
 
@@ -36,14 +61,21 @@ public:
     ~Window();
 
 public:
+    // Sleeps on SDL_WaitEventTimeout unless a frame was requested, then drains the queue
     void register_events(void);
 
-    void main_loop(const std::vector<func_t>& functions);
+    void main_loop(const std::vector<stage_t>& stages);
 
     void set_is_running(bool _is_running);
 
     void set_start_timer(uint32_t _start_timer);
 
+    // Asks for the next frame within `within_ms`, 0 keeps the loop running flat out
+    void request_frame(uint32_t within_ms);
+
+    // Aborts when a steady state frame, one without new input past the warm up, allocates
+    void set_assert_no_alloc(bool _assert_no_alloc);
+
 public:
     [[nodiscard]] SDL_Window* get_window(void) const;
 
@@ -51,11 +83,27 @@ public:
 
     [[nodiscard]] TTF_Font* get_font(void) const;
 
+    [[nodiscard]] ResourceCache* get_resources(void);
+
     [[nodiscard]] uint32_t get_start_timer(void) const;
 
     [[nodiscard]] int get_mouse_x(void) const;
 
     [[nodiscard]] int get_mouse_y(void) const;
+
+    // True once after the renderer dropped its render target contents
+    [[nodiscard]] bool consume_render_reset(void);
+
+    // Focused and not minimised
+    [[nodiscard]] bool is_active(void) const;
+
+    // Milliseconds the window has been inactive since creation, including the current stretch
+    [[nodiscard]] uint32_t get_inactive_ms(void) const;
+
+private:
+    void handle_event(const SDL_Event& e);
+
+    void set_active_state(bool _is_minimized, bool _has_focus);
 };
 
 #endif //WINDOW_H
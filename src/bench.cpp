@@ -0,0 +1,900 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+// Microbenchmarks for the engine and renderer hot paths. Engine benchmarks run
+// for every board size and mine density, renderer ones for every cell size.
+// Each one repeats until a sample is long enough to time and keeps the median
+// of a few samples. --json writes the results, --compare reads such a file back
+// as the baseline and flags every result that got slower than the threshold.
+// The renderer draws with a software renderer into a plain surface, no window.
+
+#include <SDL2/SDL.h>
+#include <SDL_ttf.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <board.h>
+#include <camera.h>
+#include <neighbour_count.h>
+#include <platform.h>
+#include <probability.h>
+#include <renderer.h>
+#include <rng.h>
+#include <solver.h>
+#include <thread_pool.h>
+
+#include "tool_args.h"
+
+// Fixed so every run times the same boards
+static constexpr uint64_t SEED{0x5EED};
+
+// Calls per timed iteration for benchmarks too short to time one call at a time
+static constexpr int CALLS_PER_OP{1 << 16};
+
+// Offscreen target of the renderer benchmarks
+static constexpr int VIEW_W{1280};
+static constexpr int VIEW_H{720};
+
+static constexpr float MINE_RADIUS{20.0f};
+
+typedef struct RESULT
+{
+    std::string name;
+    std::string params;
+    // What items_per_s counts
+    const char* unit;
+    uint64_t iterations;
+    // Median over the samples
+    double ns_per_op;
+    double items_per_s;
+} result_t;
+
+typedef struct BASELINE_ENTRY
+{
+    std::string name;
+    std::string params;
+    double ns_per_op;
+} baseline_entry_t;
+
+typedef struct BENCH
+{
+    // Substring a benchmark name has to contain to run, nullptr runs all
+    const char* filter;
+    int samples;
+    uint64_t min_sample_ns;
+    // Human readable table, stderr when the JSON goes to stdout
+    FILE* out;
+    std::vector<result_t> results;
+} bench_t;
+
+typedef struct OFFSCREEN
+{
+    SDL_Surface* surface;
+    SDL_Renderer* renderer;
+    // nullptr when the font is missing, text benchmarks are skipped then
+    TTF_Font* font;
+} offscreen_t;
+
+// Written by benchmarks of pure calls so the compiler cannot drop them
+static volatile uint64_t sink;
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static bool selected(const bench_t& bench, const std::string& name)
+{
+    return !bench.filter || name.find(bench.filter) != std::string::npos;
+}
+
+static const char* const RENDER_BENCHES[] = {
+    "renderer/batch_rect",
+    "renderer/draw_rect",
+    "renderer/batch_rounded_rect/sprite",
+    "renderer/batch_rounded_rect/tessellated",
+    "renderer/batch_heat",
+    "renderer/batch_glyphs",
+    "renderer/board_frame",
+};
+
+// Lets a filter on engine benchmarks skip setting up SDL
+static bool any_render_selected(const bench_t& bench)
+{
+    return std::any_of(std::begin(RENDER_BENCHES), std::end(RENDER_BENCHES),
+                       [&](const char* name) { return selected(bench, name); });
+}
+
+static void add_result(bench_t& bench, const std::string& name, const std::string& params, const char* unit,
+                       const uint64_t iterations, const double ns_per_op, const double items)
+{
+    const double items_per_s = ns_per_op > 0.0 ? items * 1e9 / ns_per_op : 0.0;
+    bench.results.push_back({name, params, unit, iterations, ns_per_op, items_per_s});
+
+    std::fprintf(bench.out, "%-40s %-24s %14.1f ns %14.4g %s/s\n",
+                 name.c_str(), params.c_str(), ns_per_op, items_per_s, unit);
+    std::fflush(bench.out);
+}
+
+// op runs one iteration and returns the nanoseconds it measured, so setup it
+// needs between iterations stays out of the timing. Returns the median ns per op.
+template <typename OP>
+static double run(bench_t& bench, const std::string& name, const std::string& params, const char* unit,
+                  const double items, OP op)
+{
+    // Warms caches and grows the buffers the timed iterations reuse
+    op();
+
+    std::vector<double> samples;
+    uint64_t iterations = 0;
+    for (int s = 0; s < bench.samples; ++s)
+    {
+        uint64_t ns = 0;
+        uint64_t count = 0;
+        const uint64_t wall_start = now_ns();
+
+        // Untimed setup can dwarf the timed part, the wall clock bounds the sample as well
+        while (count == 0 || (ns < bench.min_sample_ns && now_ns() - wall_start < 20 * bench.min_sample_ns))
+        {
+            ns += op();
+            ++count;
+        }
+
+        samples.push_back(static_cast<double>(ns) / static_cast<double>(count));
+        iterations += count;
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    const double median = samples[samples.size() / 2];
+
+    add_result(bench, name, params, unit, iterations, median, items);
+    return median;
+}
+
+static std::string config_params(const config_t& config)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%dx%d d=%.2f", config.cols, config.rows, config.density);
+    return buffer;
+}
+
+// Mines at roughly the config density, enough for timing the counting kernels
+static void random_mine_plane(const config_t& config, std::vector<uint64_t>& mines)
+{
+    const size_t cells = static_cast<size_t>(config.cols) * static_cast<size_t>(config.rows);
+    mines.assign((cells + 63) / 64, 0);
+
+    Rng rng{SEED};
+    const auto threshold = static_cast<uint64_t>(config.density * 18446744073709551616.0);
+    for (size_t i = 0; i < cells; ++i)
+    {
+        if (rng.next() < threshold) mines[i >> 6] |= uint64_t{1} << (i & 63);
+    }
+}
+
+// The per cell 3x3 loop the counting kernels replaced, kept as their baseline
+static void count_3x3(const uint64_t* mines, const int cols, const int rows, uint8_t* counts)
+{
+    const auto is_mine = [&](const size_t i) { return (mines[i >> 6] >> (i & 63)) & 1u; };
+
+    for (int y = 0; y < rows; ++y)
+    {
+        for (int x = 0; x < cols; ++x)
+        {
+            const size_t i = static_cast<size_t>(y) * static_cast<size_t>(cols) + static_cast<size_t>(x);
+            unsigned int count = 0;
+
+            if (!is_mine(i))
+            {
+                for (int dy = -1; dy <= 1; ++dy)
+                {
+                    for (int dx = -1; dx <= 1; ++dx)
+                    {
+                        const int nx = x + dx;
+                        const int ny = y + dy;
+                        if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+
+                        count += is_mine(static_cast<size_t>(ny) * static_cast<size_t>(cols) +
+                                         static_cast<size_t>(nx));
+                    }
+                }
+            }
+
+            const unsigned int shift = (i & 1) * 4;
+            counts[i >> 1] = static_cast<uint8_t>((counts[i >> 1] & ~(0x0Fu << shift)) | (count << shift));
+        }
+    }
+}
+
+// Fresh board of the config with the first click in the centre, generated but not revealed
+static void new_board(Board& board, const config_t& config)
+{
+    board.init(config.cols, config.rows, config.mines);
+    board.set_seed(SEED);
+    board.set_safe_radius(1);
+    board.set_track_dirty(true);
+    board.generate_tiles(config.cols / 2, config.rows / 2);
+    board.clear_dirty();
+}
+
+// Opens the centre and plays every deduction, leaves the board where a guess is needed.
+// Returns the nanoseconds spent in the solver.
+static uint64_t solve_board(Board& board, Solver& solver, const config_t& config)
+{
+    new_board(board, config);
+    solver.reset(config.cols, config.rows);
+    board.reveal(config.cols / 2, config.rows / 2);
+
+    uint64_t ns = 0;
+    while (board.get_state() == board_state::PLAYING)
+    {
+        const uint64_t start = now_ns();
+        solver.note_dirty(board);
+        board.clear_dirty();
+        solver.drain(board);
+        ns += now_ns() - start;
+
+        int x = 0;
+        int y = 0;
+        if (!solver.next_safe_move(board, x, y)) break;
+
+        board.reveal(x, y);
+    }
+    return ns;
+}
+
+static void bench_board(bench_t& bench, const config_t& config, ThreadPool& pool)
+{
+    const std::string params = config_params(config);
+    const auto cells = static_cast<double>(config.cols) * static_cast<double>(config.rows);
+
+    Board board;
+
+    // Includes the neighbour counts, generate_tiles runs the best kernel at the end
+    if (selected(bench, "board/generate_tiles"))
+    {
+        run(bench, "board/generate_tiles", params, "cells", cells, [&]() {
+            board.init(config.cols, config.rows, config.mines);
+            board.set_seed(SEED);
+            const uint64_t start = now_ns();
+            board.generate_tiles(config.cols / 2, config.rows / 2);
+            return now_ns() - start;
+        });
+    }
+
+    {
+        std::vector<uint64_t> mines;
+        random_mine_plane(config, mines);
+        std::vector<uint8_t> counts((static_cast<size_t>(cells) + 1) / 2);
+
+        for (int k = 0; k < neighbour_count::KERNEL_COUNT; ++k)
+        {
+            const auto kernel = static_cast<neighbour_count::KERNEL>(k);
+            const std::string name = std::string{"neighbour_count/"} + neighbour_count::kernel_name(kernel);
+            if (!neighbour_count::is_supported(kernel) || !selected(bench, name)) continue;
+
+            run(bench, name, params, "cells", cells, [&]() {
+                const uint64_t start = now_ns();
+                neighbour_count::count(mines.data(), config.cols, config.rows, counts.data(), kernel);
+                return now_ns() - start;
+            });
+        }
+
+        if (selected(bench, "neighbour_count/3x3_loop"))
+        {
+            run(bench, "neighbour_count/3x3_loop", params, "cells", cells, [&]() {
+                const uint64_t start = now_ns();
+                count_3x3(mines.data(), config.cols, config.rows, counts.data());
+                return now_ns() - start;
+            });
+        }
+    }
+
+    if (selected(bench, "board/reveal_flood"))
+    {
+        new_board(board, config);
+        board.reveal(config.cols / 2, config.rows / 2);
+        const auto opened = static_cast<double>(board.get_revealed_safe());
+
+        run(bench, "board/reveal_flood", params, "cells", opened, [&]() {
+            new_board(board, config);
+            const uint64_t start = now_ns();
+            board.reveal(config.cols / 2, config.rows / 2);
+            return now_ns() - start;
+        });
+    }
+
+    if (selected(bench, "board/check_win"))
+    {
+        new_board(board, config);
+        board.reveal(config.cols / 2, config.rows / 2);
+
+        run(bench, "board/check_win", params, "calls", CALLS_PER_OP, [&]() {
+            const uint64_t start = now_ns();
+            uint64_t won = 0;
+            for (int c = 0; c < CALLS_PER_OP; ++c)
+            {
+                won += board.check_win() + (board.get_revealed_safe() == board.get_safe_cells());
+            }
+            const uint64_t ns = now_ns() - start;
+            sink = won;
+            return ns;
+        });
+    }
+
+    {
+        Camera camera{platform::game::block::SIZE, platform::game::block::OFFSET};
+        camera.set_view(VIEW_W, VIEW_H);
+        camera.reset(config.cols, config.rows);
+
+        if (selected(bench, "camera/cell_at"))
+        {
+            std::vector<float> points(2 * CALLS_PER_OP);
+            Rng rng{SEED};
+            for (size_t p = 0; p < points.size(); p += 2)
+            {
+                points[p] = static_cast<float>(rng.bounded(VIEW_W));
+                points[p + 1] = static_cast<float>(rng.bounded(VIEW_H));
+            }
+
+            run(bench, "camera/cell_at", params, "calls", CALLS_PER_OP, [&]() {
+                const uint64_t start = now_ns();
+                uint64_t hits = 0;
+                for (size_t p = 0; p < points.size(); p += 2)
+                {
+                    int x = 0;
+                    int y = 0;
+                    hits += camera.cell_at(points[p], points[p + 1], config.cols, config.rows, x, y);
+                }
+                const uint64_t ns = now_ns() - start;
+                sink = hits;
+                return ns;
+            });
+        }
+
+        if (selected(bench, "camera/visible_cells"))
+        {
+            run(bench, "camera/visible_cells", params, "calls", CALLS_PER_OP, [&]() {
+                const uint64_t start = now_ns();
+                uint64_t span = 0;
+                for (int c = 0; c < CALLS_PER_OP; ++c)
+                {
+                    // Back and forth so the range keeps moving without drifting off the board
+                    camera.pan((c & 1) ? -3.0f : 3.0f, 0.0f);
+                    const cell_range_t range = camera.visible_cells(config.cols, config.rows);
+                    span += static_cast<uint64_t>(range.x1 - range.x0 + range.y1 - range.y0);
+                }
+                const uint64_t ns = now_ns() - start;
+                sink = span;
+                return ns;
+            });
+        }
+    }
+
+    Solver solver;
+
+    if (selected(bench, "solver/solve"))
+    {
+        // The solver only sees what gets opened, so the rate is over revealed cells like reveal_flood
+        solve_board(board, solver, config);
+        const auto opened = static_cast<double>(board.get_revealed_safe());
+
+        run(bench, "solver/solve", params, "cells", opened, [&]() {
+            return solve_board(board, solver, config);
+        });
+    }
+
+    if (selected(bench, "probability/frontier"))
+    {
+        solve_board(board, solver, config);
+
+        ProbabilityEngine engine{&pool};
+        const int x1 = config.cols - 1;
+        const int y1 = config.rows - 1;
+        engine.compute(board, solver, 0, 0, x1, y1);
+        const probability_stats_t stats = engine.get_stats();
+
+        // Won by deduction alone, nothing left to estimate
+        if (board.get_state() != board_state::PLAYING || stats.frontier_cells == 0) return;
+
+        run(bench, "probability/frontier", params, "cells", static_cast<double>(stats.frontier_cells), [&]() {
+            const uint64_t start = now_ns();
+            engine.compute(board, solver, 0, 0, x1, y1);
+            return now_ns() - start;
+        });
+
+        // Context for the frontier rate, not a timing of its own
+        std::fprintf(bench.out, "%-40s %-24s %zu components, %zu approximate\n", "", "",
+                     stats.components, stats.approximate_components);
+    }
+}
+
+static bool offscreen_init(offscreen_t& offscreen)
+{
+    offscreen = {};
+
+    // No display needed, SDL_VIDEODRIVER from the environment still wins over this hint
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    if (SDL_Init(SDL_INIT_VIDEO) != 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_Init failed: %s", SDL_GetError());
+        return false;
+    }
+
+    offscreen.surface = SDL_CreateRGBSurfaceWithFormat(0, VIEW_W, VIEW_H, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!offscreen.surface)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_CreateRGBSurfaceWithFormat failed: %s", SDL_GetError());
+        return false;
+    }
+
+    offscreen.renderer = SDL_CreateSoftwareRenderer(offscreen.surface);
+    if (!offscreen.renderer)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_CreateSoftwareRenderer failed: %s", SDL_GetError());
+        return false;
+    }
+    SDL_SetRenderDrawBlendMode(offscreen.renderer, SDL_BLENDMODE_BLEND);
+
+    if (TTF_Init() == 0)
+    {
+        offscreen.font = TTF_OpenFont(platform::font::PATH, platform::font::TITLE_SIZE);
+    }
+    if (!offscreen.font)
+    {
+        SDL_Log("No font at %s, skipping text benchmarks", platform::font::PATH);
+    }
+    return true;
+}
+
+static void offscreen_quit(offscreen_t& offscreen)
+{
+    if (offscreen.font) TTF_CloseFont(offscreen.font);
+    if (TTF_WasInit()) TTF_Quit();
+    if (offscreen.renderer) SDL_DestroyRenderer(offscreen.renderer);
+    if (offscreen.surface) SDL_FreeSurface(offscreen.surface);
+    SDL_Quit();
+    offscreen = {};
+}
+
+// Cells tiling the view at one size, items of the shape benchmarks
+static std::vector<SDL_FRect> grid_rects(const float size)
+{
+    std::vector<SDL_FRect> rects;
+    const float pitch = size + platform::game::block::OFFSET;
+    for (float y = 0.0f; y + size <= VIEW_H; y += pitch)
+    {
+        for (float x = 0.0f; x + size <= VIEW_W; x += pitch)
+        {
+            rects.push_back({x, y, size, size});
+        }
+    }
+    return rects;
+}
+
+// Same layers Game::draw_cell queues for the cells in view at the default zoom
+static uint64_t draw_board_frame(const offscreen_t& offscreen, const Renderer& renderer, const Board& board,
+                                 const Camera& camera)
+{
+    const uint64_t start = now_ns();
+    SDL_RenderClear(offscreen.renderer);
+
+    const cell_range_t range = camera.visible_cells(board.get_cols(), board.get_rows());
+    const float zoom = camera.get_zoom();
+    for (int y = range.y0; y <= range.y1; ++y)
+    {
+        for (int x = range.x0; x <= range.x1; ++x)
+        {
+            const size_t i = board.index(x, y);
+            const view_rect_t cell = camera.cell_rect(x, y);
+            const SDL_FRect rect{cell.x, cell.y, cell.w, cell.h};
+            const bool is_revealed = board.is_revealed(i);
+
+            renderer.batch_rect(rect, is_revealed
+                                          ? platform::game::block::color::REVELED_BG
+                                          : platform::game::block::color::BG);
+
+            if (!is_revealed || board.is_mine(i))
+            {
+                if (board.is_mine(i)) renderer.batch_rounded_rect(rect, MINE_RADIUS * zoom, {0, 0, 0, 255});
+                continue;
+            }
+
+            const unsigned int mines_around = board.mines_around(i);
+            if (mines_around == 0 || !offscreen.font) continue;
+
+            const char txt[2] = {static_cast<char>('0' + mines_around), 0};
+            const int padding = static_cast<int>(8.0f * zoom);
+            const SDL_Rect bounds{
+                static_cast<int>(rect.x) + padding, static_cast<int>(rect.y) + padding,
+                static_cast<int>(rect.w) - 2 * padding, static_cast<int>(rect.h) - 2 * padding
+            };
+            renderer.batch_txt_centered(bounds, {0, 0, 0, 255}, txt, 0.85f);
+        }
+    }
+
+    renderer.flush_batch();
+    return now_ns() - start;
+}
+
+static void bench_renderer(bench_t& bench, const offscreen_t& offscreen, const std::vector<config_t>& configs,
+                           const std::vector<int>& cell_sizes)
+{
+    const Renderer renderer{offscreen.renderer, offscreen.font};
+    renderer.cache_rounded_rect(platform::game::block::SIZE, platform::game::block::SIZE, MINE_RADIUS);
+
+    for (const int size : cell_sizes)
+    {
+        char params[32];
+        std::snprintf(params, sizeof(params), "cell=%dpx", size);
+
+        const auto f_size = static_cast<float>(size);
+        const std::vector<SDL_FRect> rects = grid_rects(f_size);
+        const auto quads = static_cast<double>(rects.size());
+        const SDL_Color color = platform::game::block::color::BG;
+
+        if (selected(bench, "renderer/batch_rect"))
+        {
+            run(bench, "renderer/batch_rect", params, "quads", quads, [&]() {
+                const uint64_t start = now_ns();
+                for (const SDL_FRect& rect : rects) renderer.batch_rect(rect, color);
+                renderer.flush_batch();
+                return now_ns() - start;
+            });
+        }
+
+        // Immediate path, one SDL call per cell, for comparison with the batch
+        if (selected(bench, "renderer/draw_rect"))
+        {
+            run(bench, "renderer/draw_rect", params, "quads", quads, [&]() {
+                const uint64_t start = now_ns();
+                for (const SDL_FRect& rect : rects) renderer.draw_rect(rect, color);
+                return now_ns() - start;
+            });
+        }
+
+        // Sprite atlas when the size was cached, tessellated otherwise
+        const float radius = MINE_RADIUS * f_size / platform::game::block::SIZE;
+        renderer.cache_rounded_rect(size, size, radius);
+        if (selected(bench, "renderer/batch_rounded_rect/sprite"))
+        {
+            run(bench, "renderer/batch_rounded_rect/sprite", params, "quads", quads, [&]() {
+                const uint64_t start = now_ns();
+                for (const SDL_FRect& rect : rects) renderer.batch_rounded_rect(rect, radius, color);
+                renderer.flush_batch();
+                return now_ns() - start;
+            });
+        }
+
+        if (selected(bench, "renderer/batch_rounded_rect/tessellated"))
+        {
+            // Off the cached size by a fraction, find_sprite only takes exact matches
+            const float other_radius = radius * 0.9f;
+            run(bench, "renderer/batch_rounded_rect/tessellated", params, "quads", quads, [&]() {
+                const uint64_t start = now_ns();
+                for (const SDL_FRect& rect : rects) renderer.batch_rounded_rect(rect, other_radius, color);
+                renderer.flush_batch();
+                return now_ns() - start;
+            });
+        }
+
+        if (selected(bench, "renderer/batch_heat"))
+        {
+            run(bench, "renderer/batch_heat", params, "quads", quads, [&]() {
+                const uint64_t start = now_ns();
+                float p = 0.0f;
+                for (const SDL_FRect& rect : rects)
+                {
+                    renderer.batch_heat(rect, p, 120);
+                    p = p < 1.0f ? p + 0.01f : 0.0f;
+                }
+                renderer.flush_batch();
+                return now_ns() - start;
+            });
+        }
+
+        if (offscreen.font && selected(bench, "renderer/batch_glyphs"))
+        {
+            // A timing line the size of the overlay ones, one per cell row
+            const auto lines = static_cast<int>(VIEW_H / (f_size + platform::game::block::OFFSET));
+            run(bench, "renderer/batch_glyphs", params, "lines", lines, [&]() {
+                const uint64_t start = now_ns();
+                for (int line = 0; line < lines; ++line)
+                {
+                    renderer.batch_glyphs(0.0f, static_cast<float>(line) * f_size, f_size, color,
+                                          "render  12.345  15.678  19.012");
+                }
+                renderer.flush_batch();
+                return now_ns() - start;
+            });
+        }
+    }
+
+    if (!selected(bench, "renderer/board_frame")) return;
+
+    Board board;
+    Solver solver;
+    Camera camera{platform::game::block::SIZE, platform::game::block::OFFSET};
+    camera.set_view(VIEW_W, VIEW_H);
+
+    for (const config_t& config : configs)
+    {
+        // Mid game: numbers, open areas and closed cells all on screen
+        solve_board(board, solver, config);
+        camera.reset(config.cols, config.rows);
+
+        const cell_range_t range = camera.visible_cells(config.cols, config.rows);
+        const double visible = static_cast<double>(range.x1 - range.x0 + 1) * (range.y1 - range.y0 + 1);
+
+        run(bench, "renderer/board_frame", config_params(config), "cells", visible, [&]() {
+            return draw_board_frame(offscreen, renderer, board, camera);
+        });
+    }
+}
+
+static void write_json_file(FILE* file, const std::vector<result_t>& results)
+{
+    std::fprintf(file, "{\n  \"results\": [\n");
+    for (size_t r = 0; r < results.size(); ++r)
+    {
+        const result_t& result = results[r];
+        std::fprintf(file,
+                     "    {\"name\": \"%s\", \"params\": \"%s\", \"unit\": \"%s\", \"iterations\": %llu, "
+                     "\"ns_per_op\": %.3f, \"items_per_s\": %.3f}%s\n",
+                     result.name.c_str(), result.params.c_str(), result.unit,
+                     static_cast<unsigned long long>(result.iterations), result.ns_per_op, result.items_per_s,
+                     r + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+}
+
+static bool write_json(const char* path, const std::vector<result_t>& results)
+{
+    if (std::strcmp(path, "-") == 0)
+    {
+        write_json_file(stdout, results);
+        return true;
+    }
+
+    FILE* file = std::fopen(path, "w");
+    if (!file) return false;
+
+    write_json_file(file, results);
+    return std::fclose(file) == 0;
+}
+
+static bool json_string(const char* line, const char* key, std::string& out)
+{
+    char pattern[64];
+    std::snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+
+    const char* start = std::strstr(line, pattern);
+    if (!start) return false;
+
+    start += std::strlen(pattern);
+    const char* end = std::strchr(start, '"');
+    if (!end) return false;
+
+    out.assign(start, end);
+    return true;
+}
+
+static bool json_number(const char* line, const char* key, double& out)
+{
+    char pattern[64];
+    std::snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+
+    const char* start = std::strstr(line, pattern);
+    if (!start) return false;
+
+    start += std::strlen(pattern);
+    char* end = nullptr;
+    out = std::strtod(start, &end);
+    return end != start;
+}
+
+// Reads back what write_json wrote, one result per line
+static bool read_baseline(const char* path, std::vector<baseline_entry_t>& out)
+{
+    FILE* file = std::fopen(path, "r");
+    if (!file) return false;
+
+    char line[1024];
+    while (std::fgets(line, sizeof(line), file))
+    {
+        baseline_entry_t entry{};
+        if (!json_string(line, "name", entry.name) || !json_string(line, "params", entry.params) ||
+            !json_number(line, "ns_per_op", entry.ns_per_op))
+        {
+            continue;
+        }
+        out.push_back(entry);
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+// Prints every result next to its baseline, returns how many got slower by more than threshold
+static int compare(FILE* out, const std::vector<result_t>& results, const std::vector<baseline_entry_t>& baseline,
+                   const double threshold)
+{
+    int regressions = 0;
+
+    std::fprintf(out, "\n%-40s %-24s %14s %14s %8s\n", "benchmark", "params", "baseline ns", "ns", "change");
+    for (const result_t& result : results)
+    {
+        const auto match = std::find_if(baseline.begin(), baseline.end(), [&](const baseline_entry_t& entry) {
+            return entry.name == result.name && entry.params == result.params;
+        });
+
+        if (match == baseline.end() || match->ns_per_op <= 0.0)
+        {
+            std::fprintf(out, "%-40s %-24s %14s %14.1f %8s  new\n",
+                         result.name.c_str(), result.params.c_str(), "-", result.ns_per_op, "-");
+            continue;
+        }
+
+        const double ratio = result.ns_per_op / match->ns_per_op;
+        const char* verdict = "";
+        if (ratio > 1.0 + threshold)
+        {
+            verdict = "  REGRESSION";
+            ++regressions;
+        }
+        else if (ratio < 1.0 / (1.0 + threshold))
+        {
+            verdict = "  faster";
+        }
+
+        std::fprintf(out, "%-40s %-24s %14.1f %14.1f %+7.1f%%%s\n",
+                     result.name.c_str(), result.params.c_str(), match->ns_per_op, result.ns_per_op,
+                     (ratio - 1.0) * 100.0, verdict);
+    }
+
+    std::fprintf(out, "%d regression%s over %.0f%%\n", regressions, regressions == 1 ? "" : "s", threshold * 100.0);
+    return regressions;
+}
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "Usage: minesweeper_bench [--sizes <w>x<h>,...] [--densities <d>,...] [--cells <px>,...]\n"
+                 "                         [--filter <text>] [--samples <n>] [--min-time <ms>] [--no-render]\n"
+                 "                         [--json <file>|-] [--compare <baseline.json>] [--threshold <percent>]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::pair<int, int>> sizes = {{30, 16}, {256, 256}, {1024, 1024}};
+    std::vector<double> densities = {0.12, 0.2};
+    std::vector<double> cell_sizes = {8, 16, 50};
+    bench_t bench{nullptr, 5, 50'000'000, stdout, {}};
+    bool render = true;
+    const char* json_path = nullptr;
+    const char* baseline_path = nullptr;
+    double threshold = 0.1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--sizes") == 0 && i + 1 < argc)
+        {
+            if (!parse_sizes(argv[++i], sizes))
+            {
+                std::fprintf(stderr, "Bad size list: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--densities") == 0 && i + 1 < argc)
+        {
+            if (!parse_list(argv[++i], densities))
+            {
+                std::fprintf(stderr, "Bad density list: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--cells") == 0 && i + 1 < argc)
+        {
+            if (!parse_list(argv[++i], cell_sizes))
+            {
+                std::fprintf(stderr, "Bad cell size list: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            bench.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+        {
+            bench.samples = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+        {
+            bench.min_sample_ns = std::max<uint64_t>(1, std::strtoull(argv[++i], nullptr, 10)) * 1000000;
+        }
+        else if (std::strcmp(argv[i], "--no-render") == 0)
+        {
+            render = false;
+        }
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            json_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+        {
+            baseline_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+        {
+            threshold = std::max(0.0, std::strtod(argv[++i], nullptr)) / 100.0;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // JSON on stdout keeps the table out of the way
+    if (json_path && std::strcmp(json_path, "-") == 0) bench.out = stderr;
+
+    std::vector<baseline_entry_t> baseline;
+    if (baseline_path && !read_baseline(baseline_path, baseline))
+    {
+        std::fprintf(stderr, "Cannot read baseline %s\n", baseline_path);
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<config_t> configs = make_configs(sizes, densities);
+
+    ThreadPool pool;
+    std::fprintf(bench.out, "best neighbour kernel: %s, %u threads\n\n",
+                 neighbour_count::kernel_name(neighbour_count::best_kernel()), pool.get_thread_count());
+
+    for (const config_t& config : configs)
+    {
+        bench_board(bench, config, pool);
+    }
+
+    if (render && any_render_selected(bench))
+    {
+        offscreen_t offscreen{};
+        if (offscreen_init(offscreen))
+        {
+            std::vector<int> pixels;
+            for (const double size : cell_sizes) pixels.push_back(std::max(1, static_cast<int>(size)));
+
+            bench_renderer(bench, offscreen, configs, pixels);
+        }
+        else
+        {
+            std::fprintf(stderr, "No offscreen renderer, skipping renderer benchmarks\n");
+        }
+        offscreen_quit(offscreen);
+    }
+
+    if (json_path && !write_json(json_path, bench.results))
+    {
+        std::fprintf(stderr, "Failed to write %s\n", json_path);
+        return EXIT_FAILURE;
+    }
+
+    if (baseline_path && compare(bench.out, bench.results, baseline, threshold) > 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
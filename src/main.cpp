@@ -4,7 +4,14 @@
 
 #include <SDL2/SDL.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 #include <platform.h>
+#include <board.h>
+#include <trace.h>
+#include <alloc_tracker.h>
 #include "game.h"
 #include "window.h"
 
@@ -12,12 +19,29 @@ platform::input::input_t input;
 
 static uint8_t current_state = platform::game_state::TITLE;
 
+static platform::game::board::board_settings_t board_settings = platform::game::board::DEFAULT;
+
 Game* game{nullptr};
 Window* main_window{nullptr};
 
+// Inactive time already taken off the game clock
+static uint32_t seen_inactive_ms{0};
+
 void update_input(void)
 {
+    // Time spent minimised or in the background does not count towards the score
+    const uint32_t inactive_ms = main_window->get_inactive_ms();
+    if (current_state == platform::game_state::PLAYING || current_state == platform::game_state::PAUSED)
+    {
+        main_window->set_start_timer(main_window->get_start_timer() + (inactive_ms - seen_inactive_ms));
+    }
+    seen_inactive_ms = inactive_ms;
+
     game->update_input(input);
+    if (main_window->consume_render_reset())
+    {
+        game->invalidate_board();
+    }
     game->set_bg_color(platform::window::COLOR);
     SDL_RenderClear(main_window->get_renderer());
 }
@@ -31,7 +55,7 @@ void render_title_screen(void)
         case platform::game_state::PLAYING:
             {
                 current_state = platform::game_state::PLAYING;
-                SDL_SetCursor(SDL_CreateSystemCursor(SDL_SYSTEM_CURSOR_ARROW));
+                main_window->get_resources()->set_cursor(SDL_SYSTEM_CURSOR_ARROW);
                 main_window->set_start_timer(SDL_GetTicks());
                 break;
             }
@@ -48,22 +72,41 @@ void render_title_screen(void)
 
 void render_game_screen(void)
 {
+    if (current_state == platform::game_state::PLAYING && !main_window->is_active())
+    {
+        current_state = platform::game_state::PAUSED;
+    }
+    else if (current_state == platform::game_state::PAUSED && main_window->is_active())
+    {
+        current_state = platform::game_state::PLAYING;
+    }
+
+    if (current_state == platform::game_state::PAUSED)
+    {
+        // Drawn only when an event wakes the loop
+        game->pause_screen(main_window->get_window());
+        return;
+    }
+
     if (current_state == platform::game_state::PLAYING)
     {
         const uint32_t current_time = SDL_GetTicks();
         const double elapsed_time = (current_time - main_window->get_start_timer()) / 1000.0;
 
         switch (game->game_loop({main_window->get_mouse_x(), main_window->get_mouse_y()}, main_window->get_window(),
-                                elapsed_time, {8, 8, 10}))
+                                elapsed_time, board_settings))
         {
         case platform::game_state::PLAYING:
             {
+                main_window->request_frame(game->idle_timeout_ms(elapsed_time));
                 break;
             }
         case platform::game_state::TITLE:
             {
                 current_state = platform::game_state::TITLE;
-                SDL_SetCursor(SDL_CreateSystemCursor(SDL_SYSTEM_CURSOR_ARROW));
+                main_window->get_resources()->set_cursor(SDL_SYSTEM_CURSOR_ARROW);
+                // Show the title right away instead of on the next event
+                main_window->request_frame(0);
                 break;
             }
         case platform::game_state::QUIT:
@@ -76,10 +119,91 @@ void render_game_screen(void)
     }
 }
 
+void render_overlay(void)
+{
+    game->draw_profiler_overlay();
+}
+
+static uint32_t reveal_budget_us = platform::game::board::REVEAL_BUDGET_US;
+static const char* trace_path{nullptr};
+static bool assert_no_alloc{false};
+static bool no_guess{false};
+
+// Usage: minesweeper [--large] [--board <w> <h> <mines>] [--seed <n>] [--reveal-budget <us>] [--trace <file>] [--assert-no-alloc]
+//                    [--no-guess]
+static void parse_args(const int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--large") == 0)
+        {
+            board_settings = platform::game::board::LARGE;
+        }
+        else if (std::strcmp(argv[i], "--board") == 0 && i + 3 < argc)
+        {
+            board_settings.w = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            board_settings.h = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            board_settings.mines = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            board_settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--reveal-budget") == 0 && i + 1 < argc)
+        {
+            reveal_budget_us = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--assert-no-alloc") == 0)
+        {
+            assert_no_alloc = true;
+        }
+        else if (std::strcmp(argv[i], "--no-guess") == 0)
+        {
+            no_guess = true;
+        }
+        else
+        {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Unknown argument: %s", argv[i]);
+        }
+    }
+
+    // Applied last so --large does not reset it
+    board_settings.no_guess = no_guess;
+
+    board_settings.w = std::clamp<uint32_t>(board_settings.w, 1, platform::game::board::MAX_SIZE);
+    board_settings.h = std::clamp<uint32_t>(board_settings.h, 1, platform::game::board::MAX_SIZE);
+
+    const uint64_t cells = static_cast<uint64_t>(board_settings.w) * board_settings.h;
+    if (board_settings.mines >= cells)
+    {
+        board_settings.mines = static_cast<uint32_t>(cells - 1);
+    }
+
+    SDL_Log("Board %ux%u with %u mines, board memory %.2f MiB",
+            board_settings.w, board_settings.h, board_settings.mines,
+            static_cast<double>(Board::memory_estimate(static_cast<int>(board_settings.w),
+                                                       static_cast<int>(board_settings.h))) / (1024.0 * 1024.0));
+}
+
 int main(int argc, char* argv[])
 {
     SDL_Init(SDL_INIT_EVERYTHING);
 
+    parse_args(argc, argv);
+
+    if (trace_path)
+    {
+#if !defined(MINESWEEPER_TRACE) || !MINESWEEPER_TRACE
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Built without MINESWEEPER_TRACE, %s will hold no zones", trace_path);
+#endif
+        trace::set_thread_name("main");
+        trace::start(trace_path);
+    }
+
     main_window = new Window{
         platform::window::WIDTH, platform::window::HEIGHT,
         platform::font::PATH, platform::window::TITLE
@@ -94,20 +218,43 @@ int main(int argc, char* argv[])
         std::exit(EXIT_FAILURE);
     }
 
-    game = new Game{main_window->get_renderer(), input, main_window->get_font()};
+    game = new Game{main_window->get_renderer(), input, main_window->get_font(), main_window->get_resources()};
     if (game == nullptr)
     {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to create game: %s", SDL_GetError());
         std::exit(EXIT_FAILURE);
     }
+    game->set_reveal_budget(reveal_budget_us);
+    if (assert_no_alloc && !alloc_tracker::is_available())
+    {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "--assert-no-alloc ignored, built without MINESWEEPER_ALLOC_TRACKING");
+    }
+    main_window->set_assert_no_alloc(assert_no_alloc);
 
     // TODO: Add pick board size screen
-    const std::vector<func_t> functions = {
-        update_input,
-        render_title_screen,
-        render_game_screen
+    const std::vector<stage_t> stages = {
+        {"input", update_input},
+        {"title", render_title_screen},
+        {"game", render_game_screen},
+        {"overlay", render_overlay}
     };
-    main_window->main_loop(functions);
+    main_window->main_loop(stages);
+
+    if (trace_path)
+    {
+        if (trace::stop())
+        {
+            SDL_Log("Wrote trace to %s", trace_path);
+        }
+        else
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to write trace to %s", trace_path);
+        }
+    }
+
+    // Game textures belong to the window's renderer, release them first
+    delete game;
+    delete main_window;
 
     return 0;
 }
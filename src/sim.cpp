@@ -0,0 +1,475 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+// Headless batch runner: plays games with a bot on every core through the
+// same Board generation and reveal code the game uses, and reports games per
+// second, win rate by board size and mine density, and per phase timings.
+// Links minesweeper_core only, no SDL.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <board.h>
+#include <no_guess.h>
+#include <probability.h>
+#include <rng.h>
+#include <solver.h>
+#include <thread_pool.h>
+#include <trace.h>
+
+#include "tool_args.h"
+
+// Same clear area around the first click the game deals with
+static constexpr int SAFE_RADIUS{1};
+
+// Games a worker takes from its own range at a time, thieves take half of what is left
+static constexpr uint64_t CHUNK{64};
+
+namespace phase
+{
+    enum PHASE
+    {
+        INIT,
+        FIRST_REVEAL,
+        REVEAL,
+        SOLVE,
+        GUESS,
+
+        COUNT,
+    };
+
+    static const char* const NAMES[COUNT] = {
+        "init",
+        "first reveal (generate + flood)",
+        "reveal",
+        "solve",
+        "guess",
+    };
+}
+
+typedef struct RESULT
+{
+    uint64_t games;
+    uint64_t wins;
+    uint64_t moves;
+    uint64_t ns;
+} result_t;
+
+// Per worker state, reused between games so steady play does not allocate
+typedef struct WORKER
+{
+    Board board;
+    Solver solver;
+    ProbabilityEngine probability{nullptr};
+    Rng rng;
+
+    std::vector<result_t> results;
+    uint64_t phase_ns[phase::COUNT];
+    uint64_t steals;
+} worker_t;
+
+// Picks the next cell to open, false to resign
+using pick_t = bool(*)(worker_t& worker, int& x, int& y);
+
+typedef struct BOT
+{
+    const char* name;
+    // Feeds the solver after every reveal
+    bool uses_solver;
+    pick_t pick;
+} bot_t;
+
+// Remaining game indices of one worker, thieves shrink it from the back
+typedef struct WORK_RANGE
+{
+    std::mutex lock;
+    uint64_t next;
+    uint64_t end;
+} work_range_t;
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static bool random_closed_cell(worker_t& worker, int& x, int& y)
+{
+    const Board& board = worker.board;
+    const size_t cells = static_cast<size_t>(board.get_cols()) * static_cast<size_t>(board.get_rows());
+
+    // A few blind draws, then a scan from a random start once most cells are open
+    size_t i = static_cast<size_t>(worker.rng.bounded(cells));
+    for (int attempt = 0; attempt < 8 && (board.is_revealed(i) || worker.solver.is_known_mine(i)); ++attempt)
+    {
+        i = static_cast<size_t>(worker.rng.bounded(cells));
+    }
+
+    for (size_t k = 0; k < cells && (board.is_revealed(i) || worker.solver.is_known_mine(i)); ++k)
+    {
+        i = i + 1 < cells ? i + 1 : 0;
+    }
+    if (board.is_revealed(i) || worker.solver.is_known_mine(i)) return false;
+
+    x = static_cast<int>(i % static_cast<size_t>(board.get_cols()));
+    y = static_cast<int>(i / static_cast<size_t>(board.get_cols()));
+    return true;
+}
+
+static bool pick_random(worker_t& worker, int& x, int& y)
+{
+    return random_closed_cell(worker, x, y);
+}
+
+// Deductions first, a random closed cell when they run out
+static bool pick_solver(worker_t& worker, int& x, int& y)
+{
+    if (worker.solver.next_safe_move(worker.board, x, y)) return true;
+
+    const uint64_t start = now_ns();
+    const bool picked = random_closed_cell(worker, x, y);
+    worker.phase_ns[phase::GUESS] += now_ns() - start;
+    return picked;
+}
+
+// Deductions first, the closed cell least likely to be a mine when they run out
+static bool pick_probability(worker_t& worker, int& x, int& y)
+{
+    if (worker.solver.next_safe_move(worker.board, x, y)) return true;
+
+    const uint64_t start = now_ns();
+    const Board& board = worker.board;
+    const int x1 = board.get_cols() - 1;
+    const int y1 = board.get_rows() - 1;
+
+    worker.probability.compute(board, worker.solver, 0, 0, x1, y1);
+    const bool picked = worker.probability.safest_cell(board, worker.solver, 0, 0, x1, y1, x, y);
+    worker.phase_ns[phase::GUESS] += now_ns() - start;
+    return picked;
+}
+
+static const bot_t BOTS[] = {
+    {"random", false, pick_random},
+    {"solver", true, pick_solver},
+    {"probability", true, pick_probability},
+};
+
+static uint64_t game_seed(const uint64_t base, const uint64_t index)
+{
+    return NoGuessGenerator::candidate_seed(base, index);
+}
+
+static void feed_solver(worker_t& worker, const bot_t& bot)
+{
+    if (!bot.uses_solver)
+    {
+        worker.board.clear_dirty();
+        return;
+    }
+
+    const uint64_t start = now_ns();
+    worker.solver.note_dirty(worker.board);
+    worker.board.clear_dirty();
+    worker.solver.drain(worker.board);
+    worker.phase_ns[phase::SOLVE] += now_ns() - start;
+}
+
+static void play(worker_t& worker, const bot_t& bot, const config_t& config, const uint64_t seed,
+                 result_t& result)
+{
+    Board& board = worker.board;
+    const uint64_t game_start = now_ns();
+
+    board.init(config.cols, config.rows, config.mines);
+    board.set_seed(seed);
+    board.set_safe_radius(SAFE_RADIUS);
+    board.set_track_dirty(true);
+    board.clear_dirty();
+    worker.solver.reset(config.cols, config.rows);
+    worker.rng.reseed(~seed);
+
+    const uint64_t init_end = now_ns();
+    worker.phase_ns[phase::INIT] += init_end - game_start;
+
+    // First click anywhere, the board is generated around it like in the game
+    board.reveal(static_cast<int>(worker.rng.bounded(static_cast<uint64_t>(config.cols))),
+                 static_cast<int>(worker.rng.bounded(static_cast<uint64_t>(config.rows))));
+    worker.phase_ns[phase::FIRST_REVEAL] += now_ns() - init_end;
+
+    uint64_t moves = 1;
+    feed_solver(worker, bot);
+
+    while (board.get_state() == board_state::PLAYING)
+    {
+        int x = 0;
+        int y = 0;
+        if (!bot.pick(worker, x, y)) break;
+
+        const uint64_t start = now_ns();
+        board.reveal(x, y);
+        worker.phase_ns[phase::REVEAL] += now_ns() - start;
+        ++moves;
+
+        feed_solver(worker, bot);
+    }
+
+    ++result.games;
+    result.wins += board.get_state() == board_state::WON ? 1 : 0;
+    result.moves += moves;
+    result.ns += now_ns() - game_start;
+}
+
+// Takes the next chunk of the worker's own range, or steals half of the fullest other range
+static bool take_work(std::vector<work_range_t>& ranges, const size_t self, uint64_t& lo, uint64_t& hi,
+                      uint64_t& steals)
+{
+    {
+        work_range_t& own = ranges[self];
+        std::lock_guard<std::mutex> guard{own.lock};
+        if (own.next < own.end)
+        {
+            lo = own.next;
+            hi = std::min(own.end, own.next + CHUNK);
+            own.next = hi;
+            return true;
+        }
+    }
+
+    while (true)
+    {
+        size_t victim = ranges.size();
+        uint64_t most = 0;
+        for (size_t k = 0; k < ranges.size(); ++k)
+        {
+            if (k == self) continue;
+
+            std::lock_guard<std::mutex> guard{ranges[k].lock};
+            const uint64_t left = ranges[k].end - ranges[k].next;
+            if (left > most)
+            {
+                most = left;
+                victim = k;
+            }
+        }
+        if (victim == ranges.size()) return false;
+
+        uint64_t stolen_lo = 0;
+        uint64_t stolen_hi = 0;
+        {
+            work_range_t& other = ranges[victim];
+            std::lock_guard<std::mutex> guard{other.lock};
+            const uint64_t left = other.end - other.next;
+            // Emptied in the meantime, look again
+            if (left == 0) continue;
+
+            stolen_hi = other.end;
+            stolen_lo = other.end - (left > CHUNK ? left / 2 : left);
+            other.end = stolen_lo;
+        }
+        ++steals;
+
+        lo = stolen_lo;
+        hi = std::min(stolen_hi, stolen_lo + CHUNK);
+
+        work_range_t& own = ranges[self];
+        std::lock_guard<std::mutex> guard{own.lock};
+        own.next = hi;
+        own.end = stolen_hi;
+        return true;
+    }
+}
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "Usage: minesweeper_sim [--games <n>] [--bot random|solver|probability] [--threads <n>]\n"
+                 "                       [--sizes <w>x<h>,...] [--densities <d>,...] [--seed <n>] [--trace <file>]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t total_games = 1000000;
+    const bot_t* bot = &BOTS[1];
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::pair<int, int>> sizes = {{9, 9}, {16, 16}, {30, 16}};
+    std::vector<double> densities = {0.12, 0.16, 0.2};
+    uint64_t seed = 1;
+    const char* trace_path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+        {
+            total_games = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--bot") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+            bot = nullptr;
+            for (const bot_t& candidate : BOTS)
+            {
+                if (std::strcmp(candidate.name, name) == 0) bot = &candidate;
+            }
+            if (!bot)
+            {
+                std::fprintf(stderr, "Unknown bot: %s\n", name);
+                usage();
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threads = std::max(1u, static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else if (std::strcmp(argv[i], "--sizes") == 0 && i + 1 < argc)
+        {
+            if (!parse_sizes(argv[++i], sizes))
+            {
+                std::fprintf(stderr, "Bad size list: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--densities") == 0 && i + 1 < argc)
+        {
+            if (!parse_list(argv[++i], densities))
+            {
+                std::fprintf(stderr, "Bad density list: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    const std::vector<config_t> configs = make_configs(sizes, densities);
+
+    // Exactly the requested games, the first total % configs configs play one more
+    const uint64_t games = total_games;
+    const uint64_t per_config = games / configs.size();
+    const uint64_t longer = games % configs.size();
+    const uint64_t longer_games = longer * (per_config + 1);
+
+    const auto config_of = [&](const uint64_t g) {
+        return static_cast<size_t>(g < longer_games ? g / (per_config + 1)
+                                                    : longer + (g - longer_games) / per_config);
+    };
+
+    if (trace_path)
+    {
+        trace::set_thread_name("main");
+        trace::start(trace_path);
+    }
+
+    std::vector<worker_t> workers(threads);
+    std::vector<work_range_t> ranges(threads);
+    for (unsigned int t = 0; t < threads; ++t)
+    {
+        workers[t].results.assign(configs.size(), result_t{});
+        std::fill(std::begin(workers[t].phase_ns), std::end(workers[t].phase_ns), 0);
+        workers[t].steals = 0;
+
+        // Even split up front, stealing evens out the sizes that take longer
+        ranges[t].next = games * t / threads;
+        ranges[t].end = games * (t + 1) / threads;
+    }
+
+    ThreadPool pool{threads - 1};
+    const uint64_t start = now_ns();
+
+    pool.parallel_for(threads, [&](const size_t t) {
+        TRACE_ZONE("sim_worker");
+
+        worker_t& worker = workers[t];
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        while (take_work(ranges, t, lo, hi, worker.steals))
+        {
+            for (uint64_t g = lo; g < hi; ++g)
+            {
+                const size_t c = config_of(g);
+                play(worker, *bot, configs[c], game_seed(seed, g), worker.results[c]);
+            }
+        }
+    });
+
+    const double seconds = static_cast<double>(now_ns() - start) / 1e9;
+
+    if (trace_path && !trace::stop())
+    {
+        std::fprintf(stderr, "Failed to write trace to %s\n", trace_path);
+    }
+
+    std::vector<result_t> totals(configs.size(), result_t{});
+    uint64_t phase_ns[phase::COUNT]{};
+    uint64_t steals = 0;
+    for (const worker_t& worker : workers)
+    {
+        for (size_t c = 0; c < configs.size(); ++c)
+        {
+            totals[c].games += worker.results[c].games;
+            totals[c].wins += worker.results[c].wins;
+            totals[c].moves += worker.results[c].moves;
+            totals[c].ns += worker.results[c].ns;
+        }
+        for (int p = 0; p < phase::COUNT; ++p) phase_ns[p] += worker.phase_ns[p];
+        steals += worker.steals;
+    }
+
+    uint64_t played = 0;
+    for (const result_t& r : totals) played += r.games;
+
+    std::printf("bot %s, %u threads, %llu of %llu requested games in %.2f s, %.0f games/s, %llu steals\n\n",
+                bot->name, threads, static_cast<unsigned long long>(played),
+                static_cast<unsigned long long>(total_games), seconds,
+                seconds > 0.0 ? static_cast<double>(played) / seconds : 0.0, static_cast<unsigned long long>(steals));
+
+    std::printf("%-12s %8s %8s %10s %10s %8s %10s %10s\n", "size", "mines", "density", "games", "wins", "win %",
+                "moves", "us/game");
+    for (size_t c = 0; c < configs.size(); ++c)
+    {
+        const result_t& r = totals[c];
+        char size[32];
+        std::snprintf(size, sizeof(size), "%dx%d", configs[c].cols, configs[c].rows);
+        std::printf("%-12s %8d %8.3f %10llu %10llu %8.2f %10.1f %10.2f\n", size, configs[c].mines,
+                    configs[c].density, static_cast<unsigned long long>(r.games),
+                    static_cast<unsigned long long>(r.wins),
+                    r.games ? 100.0 * static_cast<double>(r.wins) / static_cast<double>(r.games) : 0.0,
+                    r.games ? static_cast<double>(r.moves) / static_cast<double>(r.games) : 0.0,
+                    r.games ? static_cast<double>(r.ns) / 1e3 / static_cast<double>(r.games) : 0.0);
+    }
+
+    // Thread time, so shares add up over all workers
+    uint64_t phase_total = 0;
+    for (const uint64_t ns : phase_ns) phase_total += ns;
+
+    std::printf("\n%-32s %10s %8s %10s\n", "phase", "thread s", "share", "us/game");
+    for (int p = 0; p < phase::COUNT; ++p)
+    {
+        std::printf("%-32s %10.3f %7.1f%% %10.3f\n", phase::NAMES[p], static_cast<double>(phase_ns[p]) / 1e9,
+                    phase_total ? 100.0 * static_cast<double>(phase_ns[p]) / static_cast<double>(phase_total) : 0.0,
+                    played ? static_cast<double>(phase_ns[p]) / 1e3 / static_cast<double>(played) : 0.0);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,82 @@
+//
+// Created by roki on 2026-10-18.
+//
+
+// Command line and config helpers shared by minesweeper_sim and minesweeper_bench
+
+#ifndef TOOL_ARGS_H
+#define TOOL_ARGS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include <board.h>
+
+typedef struct CONFIG
+{
+    int cols;
+    int rows;
+    int mines;
+    double density;
+} config_t;
+
+// Comma separated numbers, "0.1,0.15"
+inline bool parse_list(const char* text, std::vector<double>& out)
+{
+    out.clear();
+    const char* p = text;
+    while (*p)
+    {
+        char* end = nullptr;
+        const double value = std::strtod(p, &end);
+        if (end == p) return false;
+
+        out.push_back(value);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return !out.empty();
+}
+
+// Comma separated board sizes, "16x16,30x16"
+inline bool parse_sizes(const char* text, std::vector<std::pair<int, int>>& out)
+{
+    out.clear();
+    const char* p = text;
+    while (*p)
+    {
+        char* end = nullptr;
+        const long w = std::strtol(p, &end, 10);
+        if (end == p || (*end != 'x' && *end != 'X')) return false;
+
+        p = end + 1;
+        const long h = std::strtol(p, &end, 10);
+        if (end == p || w <= 0 || h <= 0 || w > Board::MAX_SIZE || h > Board::MAX_SIZE) return false;
+
+        out.emplace_back(static_cast<int>(w), static_cast<int>(h));
+        p = *end == ',' ? end + 1 : end;
+    }
+    return !out.empty();
+}
+
+// Every size with every density, at least one mine and one safe cell each
+inline std::vector<config_t> make_configs(const std::vector<std::pair<int, int>>& sizes,
+                                          const std::vector<double>& densities)
+{
+    std::vector<config_t> configs;
+    configs.reserve(sizes.size() * densities.size());
+    for (const auto& size : sizes)
+    {
+        for (const double density : densities)
+        {
+            const int cells = size.first * size.second;
+            const int mines = std::clamp(static_cast<int>(std::lround(density * cells)), 1, std::max(1, cells - 1));
+            configs.push_back({size.first, size.second, mines, static_cast<double>(mines) / cells});
+        }
+    }
+    return configs;
+}
+
+#endif //TOOL_ARGS_H